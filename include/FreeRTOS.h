@@ -250,9 +250,15 @@
 #ifndef portSOFTWARE_BARRIER
 #define portSOFTWARE_BARRIER()
 #endif
+#ifndef portCACHE_LINE_SIZE
+#define portCACHE_LINE_SIZE 64
+#endif
 #ifndef configRUN_MULTIPLE_PRIORITIES
 #define configRUN_MULTIPLE_PRIORITIES 0
 #endif
+#if (configNUMBER_OF_CORES > 1) && (configRUN_MULTIPLE_PRIORITIES == 0)
+#error configRUN_MULTIPLE_PRIORITIES must be set to 1 when configNUMBER_OF_CORES is more than 1.
+#endif
 #ifndef portGET_CORE_ID
 #if (configNUMBER_OF_CORES == 1)
 #define portGET_CORE_ID() 0
@@ -298,9 +304,60 @@
 #ifndef configUSE_CORE_AFFINITY
 #define configUSE_CORE_AFFINITY 0
 #endif
+#if (configUSE_CORE_AFFINITY == 1) && (configNUMBER_OF_CORES == 1)
+#error configUSE_CORE_AFFINITY is not supported when configNUMBER_OF_CORES is 1.
+#endif
 #ifndef configUSE_PASSIVE_IDLE_HOOK
 #define configUSE_PASSIVE_IDLE_HOOK 0
 #endif
+#ifndef configUSE_EDF_SCHEDULING
+#define configUSE_EDF_SCHEDULING 0
+#endif
+#ifndef configEDF_PRIORITY
+#define configEDF_PRIORITY (configMAX_PRIORITIES - 1)
+#endif
+#ifndef configEDF_MAX_TASKS
+#define configEDF_MAX_TASKS 8
+#endif
+#if (configUSE_EDF_SCHEDULING == 1) && (configNUMBER_OF_CORES > 1)
+#error configUSE_EDF_SCHEDULING is only supported when configNUMBER_OF_CORES is 1.
+#endif
+#if (configUSE_EDF_SCHEDULING == 1) && ((configEDF_PRIORITY < 1) || (configEDF_PRIORITY >= configMAX_PRIORITIES))
+#error configEDF_PRIORITY must be above the idle priority and below configMAX_PRIORITIES.
+#endif
+#ifndef configUSE_TASK_BUDGETS
+#define configUSE_TASK_BUDGETS 0
+#endif
+#ifndef configBUDGET_EXHAUSTED_PRIORITY
+#define configBUDGET_EXHAUSTED_PRIORITY 0
+#endif
+#if (configUSE_TASK_BUDGETS == 1) && (configBUDGET_EXHAUSTED_PRIORITY >= configMAX_PRIORITIES)
+#error configBUDGET_EXHAUSTED_PRIORITY must be below configMAX_PRIORITIES.
+#endif
+#ifndef configUSE_MUTEX_FAST_PATH
+#define configUSE_MUTEX_FAST_PATH 0
+#endif
+#ifndef configUSE_ADAPTIVE_MUTEX
+#define configUSE_ADAPTIVE_MUTEX 0
+#endif
+#ifndef configMUTEX_MAX_SPIN
+#define configMUTEX_MAX_SPIN 1000
+#endif
+#if (configUSE_ADAPTIVE_MUTEX == 1) && (configNUMBER_OF_CORES == 1)
+#error configUSE_ADAPTIVE_MUTEX is not supported when configNUMBER_OF_CORES is 1.
+#endif
+#ifndef configUSE_PRIORITY_EVENT_LISTS
+#define configUSE_PRIORITY_EVENT_LISTS 0
+#endif
+#ifndef configUSE_QUEUE_HANDOFF
+#define configUSE_QUEUE_HANDOFF 0
+#endif
+#ifndef configUSE_QUEUE_ZERO_COPY
+#define configUSE_QUEUE_ZERO_COPY 0
+#endif
+#ifndef configUSE_SPSC_QUEUES
+#define configUSE_SPSC_QUEUES 0
+#endif
 
 #if configUSE_TIMERS == 1
 #ifndef portTIMER_CALLBACK_ATTRIBUTE
@@ -308,8 +365,12 @@
 #endif
 #endif
 #define portHAS_NESTED_INTERRUPTS 0
+#ifndef portSET_INTERRUPT_MASK_FROM_ISR
 #define portSET_INTERRUPT_MASK_FROM_ISR() 0
+#endif
+#ifndef portCLEAR_INTERRUPT_MASK_FROM_ISR
 #define portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedStatusValue) (void)(uxSavedStatusValue)
+#endif
 #ifndef portSETUP_TCB
 #define portSETUP_TCB(pxTCB) (void)(pxTCB)
 #endif
@@ -357,6 +418,24 @@
 #ifndef configUSE_TICKLESS_IDLE
 #define configUSE_TICKLESS_IDLE 0
 #endif
+#ifndef configUSE_VIRTUAL_TIME
+#define configUSE_VIRTUAL_TIME 0
+#endif
+#if (configUSE_TICKLESS_IDLE != 0) && (configUSE_VIRTUAL_TIME == 1)
+#error configUSE_TICKLESS_IDLE cannot be used with configUSE_VIRTUAL_TIME, which has no tick to suppress.
+#endif
+#ifndef configUSE_DELAYED_TASK_WHEEL
+#define configUSE_DELAYED_TASK_WHEEL 0
+#endif
+#ifndef configUSE_TIMER_WHEEL
+#define configUSE_TIMER_WHEEL 0
+#endif
+#ifndef configTIMING_WHEEL_SLOT_BITS
+#define configTIMING_WHEEL_SLOT_BITS 6
+#endif
+#if (configTIMING_WHEEL_SLOT_BITS < 1) || (configTIMING_WHEEL_SLOT_BITS > 6)
+#error configTIMING_WHEEL_SLOT_BITS must be between 1 and 6, as each wheel level is tracked in a 64-bit occupancy mask.
+#endif
 #ifndef configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING
 #define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING(x)
 #endif
@@ -378,6 +457,15 @@
 #ifndef configUSE_TIME_SLICING
 #define configUSE_TIME_SLICING 1
 #endif
+#ifndef configUSE_TASK_TIME_SLICE
+#define configUSE_TASK_TIME_SLICE 0
+#endif
+#ifndef configDEFAULT_TIME_SLICE
+#define configDEFAULT_TIME_SLICE 1
+#endif
+#if (configUSE_TASK_TIME_SLICE == 1) && (configDEFAULT_TIME_SLICE < 1)
+#error configDEFAULT_TIME_SLICE must be at least one tick.
+#endif
 #ifndef configINCLUDE_APPLICATION_DEFINED_S
 #define configINCLUDE_APPLICATION_DEFINED_S 0
 #endif
@@ -534,9 +622,22 @@ typedef struct xSTATIC_MINI_LIST_ITEM StaticMiniListItem_t;
 typedef struct xSTATIC_LIST {
   UBaseType_t uxDummy2;
   void *pvDummy3;
-  StaticMiniListItem_t xDummy4;
+  StaticListItem_t xDummy4;
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+  void *pvDummy5;
+#endif
 } StaticList_t;
 
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+typedef struct xSTATIC_EVENT_LIST {
+  StaticList_t xDummy1;
+  void *pvDummy2[configMAX_PRIORITIES];
+  UBaseType_t uxDummy3[1 + ((configMAX_PRIORITIES + (sizeof(UBaseType_t) * 8) - 1) / (sizeof(UBaseType_t) * 8))];
+} StaticEventList_t;
+#else
+typedef StaticList_t StaticEventList_t;
+#endif
+
 typedef struct xSTATIC_TCB {
   void *pxDummy1;
   StaticListItem_t xDummy3[2];
@@ -544,11 +645,36 @@ typedef struct xSTATIC_TCB {
   void *pxDummy6;
   uint8_t ucDummy7[configMAX_TASK_NAME_LEN];
   UBaseType_t uxDummy9;
-  UBaseType_t uxDummy12[2];
+  UBaseType_t uxDummy12;
+  StaticList_t xDummy13;
+  void *pvDummy14;
   uint32_t ulDummy18[configTASK_NOTIFICATION_ARRAY_ENTRIES];
   uint8_t ucDummy19[configTASK_NOTIFICATION_ARRAY_ENTRIES];
   uint8_t uxDummy20;
   uint8_t ucDummy21;
+  uint8_t ucDummy22;
+#if (configNUMBER_OF_CORES > 1)
+  BaseType_t xDummy23;
+  BaseType_t xDummy24;
+#endif
+#if (configUSE_CORE_AFFINITY == 1)
+  UBaseType_t uxDummy25;
+#endif
+#if (configUSE_EDF_SCHEDULING == 1)
+  TickType_t xDummy26[3];
+  UBaseType_t uxDummy27[2];
+#endif
+#if (configUSE_TASK_BUDGETS == 1)
+  StaticListItem_t xDummy28;
+  TickType_t xDummy29[4];
+  uint8_t ucDummy30;
+#endif
+#if (configUSE_TASK_TIME_SLICE == 1)
+  TickType_t xDummy31[2];
+#endif
+#if (configUSE_QUEUE_HANDOFF == 1)
+  void *pvDummy32;
+#endif
 } StaticTask_t;
 
 typedef struct xSTATIC_QUEUE {
@@ -556,21 +682,52 @@ typedef struct xSTATIC_QUEUE {
   union {
     void *pvDummy2;
     UBaseType_t uxDummy2;
+    struct {
+      void *pvDummy8[2];
+      StaticListItem_t xDummy9;
+      UBaseType_t uxDummy10[2];
+#if (configUSE_MUTEX_FAST_PATH == 1)
+      void *pvDummy12;
+#endif
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+      UBaseType_t uxDummy13[4];
+#endif
+    } xDummy11;
   } u;
-  StaticList_t xDummy3[2];
+  StaticEventList_t xDummy3[2];
   UBaseType_t uxDummy4[3];
   uint8_t ucDummy5[2];
   uint8_t ucDummy6;
   void *pvDummy7;
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+  uint8_t ucDummy8[2];
+#endif
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
+typedef struct xSTATIC_COND_VAR {
+  void *pvDummy1;
+  StaticList_t xDummy2;
+  uint8_t ucDummy3;
+} StaticCondVar_t;
+
 typedef struct xSTATIC_EVENT_GROUP {
   TickType_t xDummy1;
   StaticList_t xDummy2;
   uint8_t ucDummy4;
 } StaticEventGroup_t;
 
+typedef struct xSTATIC_RWLOCK {
+  UBaseType_t uxDummy1[2];
+  struct {
+    void *pvDummy2[2];
+    StaticListItem_t xDummy3;
+    UBaseType_t uxDummy4;
+  } xDummy5[2];
+  StaticList_t xDummy6[2];
+  uint8_t ucDummy7[2];
+} StaticRWLock_t;
+
 typedef struct xSTATIC_TIMER {
   void *pvDummy1;
   StaticListItem_t xDummy2;
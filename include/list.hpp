@@ -33,6 +33,11 @@
 template <class T>
 struct List_t;
 
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+template <class T>
+struct ListBuckets_t;
+#endif
+
 template <class T>
 struct Item_t {
   TickType_t Value;
@@ -45,6 +50,11 @@ struct Item_t {
 
   UBaseType_t remove() {
     auto *const List = Container;
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+    if (List->Buckets != nullptr) {
+      List->Buckets->unlink(this, &List->End);
+    }
+#endif
     Next->Prev = Prev;
     Prev->Next = Next;
     if (List->Index == this) {
@@ -67,8 +77,14 @@ struct List_t {
   UBaseType_t Length;
   Item_t<T> *Index;
   Item_t<T> End;
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+  ListBuckets_t<T> *Buckets;
+#endif
 
   void init() {
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+    Buckets = nullptr;
+#endif
     Index = &(End);
     End.Value = portMAX_DELAY;
     End.Next = &(End);
@@ -89,11 +105,11 @@ struct List_t {
   }
 
   void append(Item_t<T> *item) {
-    Item_t<T> *const Index = Index;
-    item->Next = Index;
-    item->Prev = Index->Prev;
-    Index->Prev->Next = item;
-    Index->Prev = item;
+    Item_t<T> *const index = Index;
+    item->Next = index;
+    item->Prev = index->Prev;
+    index->Prev->Next = item;
+    index->Prev = item;
     item->Container = this;
     Length++;
   }
@@ -103,6 +119,10 @@ struct List_t {
     const TickType_t value = item->Value;
     if (value == portMAX_DELAY) {
       prev = prev->Prev;
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+    } else if ((Buckets != nullptr) && ListBuckets_t<T>::covers(value)) {
+      prev = Buckets->place(item, &End);
+#endif
     } else {
       while (prev->Next->Value <= value) {
         prev = prev->Next;
@@ -116,3 +136,92 @@ struct List_t {
     Length++;
   }
 };
+
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+// Index over a list kept in Value order whose values are event list priorities, 1 to configMAX_PRIORITIES. Tail holds
+// the last item of each value present, NULL for the others, and the bitmap says which values are present, so an item
+// finds its place without walking the list.
+template <class T>
+struct ListBuckets_t {
+  static constexpr UBaseType_t WordBits = sizeof(UBaseType_t) * 8U;
+  static constexpr UBaseType_t Words = (configMAX_PRIORITIES + WordBits - 1U) / WordBits;
+  static_assert(Words <= WordBits, "configMAX_PRIORITIES is too large for a two-level event list bitmap");
+
+  Item_t<T> *Tail[configMAX_PRIORITIES];
+  UBaseType_t Summary;
+  UBaseType_t Word[Words];
+
+  void init() {
+    for (UBaseType_t Slot = 0U; Slot < (UBaseType_t)configMAX_PRIORITIES; Slot++) {
+      Tail[Slot] = nullptr;
+    }
+    Summary = 0U;
+    for (UBaseType_t word = 0U; word < Words; word++) {
+      Word[word] = 0U;
+    }
+  }
+
+  static bool covers(const TickType_t Value) { return (Value >= 1U) && (Value <= (TickType_t)configMAX_PRIORITIES); }
+
+  // Records Item as the last of its value and returns the item it goes after: the last one with the same or a lower
+  // value, or End if there is none.
+  Item_t<T> *place(Item_t<T> *Item, Item_t<T> *End) {
+    const UBaseType_t Slot = (UBaseType_t)Item->Value - 1U;
+    UBaseType_t word = Slot / WordBits;
+    UBaseType_t Bits = Word[word] & atOrBelow(Slot % WordBits);
+    if ((Bits == 0U) && (word > 0U)) {
+      const UBaseType_t Lower = Summary & atOrBelow(word - 1U);
+      if (Lower != 0U) {
+        portGET_HIGHEST_PRIORITY(word, Lower);
+        Bits = Word[word];
+      }
+    }
+    Item_t<T> *Prev = End;
+    if (Bits != 0U) {
+      UBaseType_t bit;
+      portGET_HIGHEST_PRIORITY(bit, Bits);
+      Prev = Tail[word * WordBits + bit];
+    }
+    Tail[Slot] = Item;
+    Word[Slot / WordBits] |= (UBaseType_t)1U << (Slot % WordBits);
+    Summary |= (UBaseType_t)1U << (Slot / WordBits);
+    return Prev;
+  }
+
+  // Called while Item is still linked, before it leaves the list.
+  void unlink(Item_t<T> *Item, Item_t<T> *End) {
+    if (!covers(Item->Value)) {
+      return;
+    }
+    const UBaseType_t Slot = (UBaseType_t)Item->Value - 1U;
+    if (Tail[Slot] != Item) {
+      return;
+    }
+    if ((Item->Prev != End) && (Item->Prev->Value == Item->Value)) {
+      Tail[Slot] = Item->Prev;
+    } else {
+      Tail[Slot] = nullptr;
+      Word[Slot / WordBits] &= ~((UBaseType_t)1U << (Slot % WordBits));
+      if (Word[Slot / WordBits] == 0U) {
+        Summary &= ~((UBaseType_t)1U << (Slot / WordBits));
+      }
+    }
+  }
+
+ private:
+  static UBaseType_t atOrBelow(const UBaseType_t Bit) { return ~(UBaseType_t)0U >> (WordBits - 1U - Bit); }
+};
+
+// A list ordered by priority, as event lists are, that carries its own bucket index so that insert takes constant
+// time. Everything else treats it as the plain list it derives from.
+template <class T>
+struct PriorityList_t : List_t<T> {
+  ListBuckets_t<T> Slots;
+
+  void init() {
+    List_t<T>::init();
+    Slots.init();
+    this->Buckets = &Slots;
+  }
+};
+#endif
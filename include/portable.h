@@ -66,7 +66,11 @@
 #define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP 0
 #endif
 
+#if (portHAS_STACK_OVERFLOW_CHECKING == 1)
+StackType_t *PortInitialiseStack(StackType_t *StackTop, StackType_t *StackEnd, TaskFunction_t Code, void *Params);
+#else
 StackType_t *PortInitialiseStack(StackType_t *StackTop, TaskFunction_t Code, void *Params);
+#endif
 
 typedef struct HeapRegion {
   uint8_t *pucStartAddress;
@@ -80,12 +80,33 @@ BaseType_t GiveFromISR(QueueHandle_t q, BaseType_t *const woken);
 
 BaseType_t RecvFromISR(QueueHandle_t q, void *const pvBuffer, BaseType_t *const woken);
 
+// Move up to n items in one go, with one critical section and one round of wakeups. A call blocks, for at most ticks,
+// only until it can move at least one item, and returns how many it moved.
+UBaseType_t SendN(QueueHandle_t q, const void *const items, const UBaseType_t n, TickType_t ticks);
+UBaseType_t RecvN(QueueHandle_t q, void *const buf, const UBaseType_t n, TickType_t ticks);
+UBaseType_t SendNFromISR(QueueHandle_t q, const void *const items, const UBaseType_t n, BaseType_t *const woken);
+UBaseType_t RecvNFromISR(QueueHandle_t q, void *const buf, const UBaseType_t n, BaseType_t *const woken);
+
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+// Hand out the next free slot, or the next item, in place in the queue's storage, or NULL if ticks passed first. Until
+// the matching commit or release the queue looks full to other senders, or empty to other receivers, so each side has
+// at most one slot out at a time.
+void *QueueReserve(QueueHandle_t q, TickType_t ticks);
+BaseType_t QueueCommit(QueueHandle_t q);
+void *QueueAcquire(QueueHandle_t q, TickType_t ticks);
+BaseType_t QueueRelease(QueueHandle_t q);
+#endif
+
 BaseType_t QueueIsQueueEmptyFromISR(const QueueHandle_t q);
 BaseType_t QueueIsQueueFullFromISR(const QueueHandle_t q);
 UBaseType_t uxQueueMessagesWaitingFromISR(const QueueHandle_t q);
 
 QueueHandle_t QueueCreateMutex(const uint8_t type);
 QueueHandle_t QueueCreateMuteStatic(const uint8_t type, StaticQueue_t *pStaticQueue);
+// A mutex whose holder runs at Ceiling from the moment it takes the mutex, which should be the highest priority of
+// the tasks that use it.
+QueueHandle_t QueueCreateMutexCeiling(UBaseType_t Ceiling);
+QueueHandle_t QueueCreateMutexCeilingStatic(UBaseType_t Ceiling, StaticQueue_t *pStaticQueue);
 QueueHandle_t QueueCreateCountingSemaphore(const UBaseType_t maxCount, const UBaseType_t initCount);
 QueueHandle_t QueueCreateCountingSemaphoreStatic(const UBaseType_t maxCount, const UBaseType_t initCount,
                                                  StaticQueue_t *pStaticQueue);
@@ -96,8 +117,23 @@ TaskHandle_t QueueGetMutexHolderFromISR(QueueHandle_t xSemaphore);
 bool QueueTakeMutexRecursive(QueueHandle_t xMutex, TickType_t ticks);
 BaseType_t QueueGiveMutexRecursive(QueueHandle_t xMutex);
 
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+// How often takes of a mutex that found it held spun until it was free, gave up spinning, and blocked.
+struct MutexSpinStats_t {
+  UBaseType_t SpinAcquired;
+  UBaseType_t SpinFailed;
+  UBaseType_t Blocked;
+  // The most turns the next take will spin for.
+  UBaseType_t SpinLimit;
+};
+
+void QueueGetMutexSpinStats(QueueHandle_t Mutex, MutexSpinStats_t *Stats);
+#endif
+
 #define QueueReset(xQueue) QueueGenericReset((xQueue), false)
 
+BaseType_t QueueGenericReset(QueueHandle_t q, BaseType_t isNew);
+
 QueueHandle_t QueueCreate(const UBaseType_t len, const UBaseType_t itemSize);
 
 QueueHandle_t QueueCreateStatic(const UBaseType_t len, const UBaseType_t itemSize, uint8_t *storage,
@@ -115,4 +151,32 @@ QueueSetMemberHandle_t QueueSelectFromSet(QueueSetHandle_t QueueSet, const TickT
 
 QueueSetMemberHandle_t QueueSelectFromSetFromISR(QueueSetHandle_t QueueSet);
 
+// A condition variable over a mutex, which the caller holds around a wait. Notifying while the mutex is held moves the
+// waiters onto the mutex's wait list instead of waking them, so they run one at a time as the mutex is given back.
+// Waits may end early, so callers check their condition again.
+struct CondVar_t;
+typedef struct CondVar_t *CondVarHandle_t;
+
+CondVarHandle_t CondVarCreate(QueueHandle_t Mutex);
+CondVarHandle_t CondVarCreateStatic(QueueHandle_t Mutex, StaticCondVar_t *pStaticCondVar);
+// Returns false if ticks passed before a notification. The mutex is held again on return either way.
+BaseType_t CondVarWait(CondVarHandle_t Cond, TickType_t ticks);
+void CondVarNotify(CondVarHandle_t Cond);
+void CondVarNotifyAll(CondVarHandle_t Cond);
+void CondVarDelete(CondVarHandle_t Cond);
+
+#if (configUSE_SPSC_QUEUES == 1)
+// A lock-free queue for one producer, which may be an interrupt, and one consumer task. Sends never block and take no
+// critical section; the consumer is woken through its task notification at tskDEFAULT_INDEX_TO_NOTIFY, and only when
+// an item finds the queue empty.
+struct SPSCQueue_t;
+typedef struct SPSCQueue_t *SPSCQueueHandle_t;
+
+SPSCQueueHandle_t QueueCreateSPSC(const UBaseType_t len, const UBaseType_t itemSize);
+BaseType_t QueueSendSPSC(SPSCQueueHandle_t q, const void *const item);
+BaseType_t QueueSendSPSCFromISR(SPSCQueueHandle_t q, const void *const item, BaseType_t *const woken);
+BaseType_t QueueRecvSPSC(SPSCQueueHandle_t q, void *const buf, TickType_t ticks);
+void QueueDeleteSPSC(SPSCQueueHandle_t q);
+#endif
+
 void vQueueWaitForMessageRestricted(QueueHandle_t q, TickType_t ticks, const BaseType_t xWaitIndefinitely);
@@ -0,0 +1,48 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#pragma once
+
+#include "task.hpp"
+
+// A reader-writer lock. Any number of readers may hold it at once, or a single writer. Writers take precedence: once a
+// writer waits, new readers wait behind it. A writer inherits the priority of the tasks waiting for the lock.
+struct RWLock_t;
+typedef struct RWLock_t *RWLockHandle_t;
+
+RWLockHandle_t RWLockCreate(void);
+RWLockHandle_t RWLockCreateStatic(StaticRWLock_t *pStaticRWLock);
+
+BaseType_t RWLockReadTake(RWLockHandle_t Lock, TickType_t ticks);
+BaseType_t RWLockReadGive(RWLockHandle_t Lock);
+
+BaseType_t RWLockWriteTake(RWLockHandle_t Lock, TickType_t ticks);
+BaseType_t RWLockWriteGive(RWLockHandle_t Lock);
+
+void RWLockDelete(RWLockHandle_t Lock);
@@ -58,6 +58,9 @@ typedef QueueHandle_t SemaphoreHandle_t;
 #define xSemaphoreCreateMutex() QueueCreateMutex(queueQUEUE_TYPE_MUTEX)
 #define xSemaphoreCreateMuteStatic(MutexBuffer) QueueCreateMuteStatic(queueQUEUE_TYPE_MUTEX, (MutexBuffer))
 #define xSemaphoreCreateRecursiveMutex() QueueCreateMutex(queueQUEUE_TYPE_RECURSIVE_MUTEX)
+#define xSemaphoreCreateMutexCeiling(uxCeiling) QueueCreateMutexCeiling((uxCeiling))
+#define xSemaphoreCreateMutexCeilingStatic(uxCeiling, MutexBuffer) \
+  QueueCreateMutexCeilingStatic((uxCeiling), (MutexBuffer))
 #define xSemaphoreCreateRecursiveMuteStatic(pStaticSemaphore) \
   QueueCreateMuteStatic(queueQUEUE_TYPE_RECURSIVE_MUTEX, (pStaticSemaphore))
 #define xSemaphoreCreateCounting(uxMaxCount, uxInitialCount) \
@@ -27,7 +27,7 @@
  *
  */
 #pragma once
-#include "freertos.h"
+#include "FreeRTOS.h"
 #include "portmacro.h"
 #define sbTYPE_STREAM_BUFFER ((BaseType_t)0)
 #define sbTYPE_MESSAGE_BUFFER ((BaseType_t)1)
@@ -53,6 +53,16 @@ typedef struct xTIME_OUT {
   TickType_t TimeOnEntering;
 } TimeOut_t;
 
+// A mutex as priority inheritance sees it. The holder runs at no lower a priority than the tasks in Waiters, which are
+// kept in priority order, nor than Ceiling, and HeldItem links the mutex into the holder's list of held mutexes.
+struct MutexLink_t {
+  TaskHandle_t Holder;
+  List_t<TCB_t> *Waiters;
+  Item_t<MutexLink_t> HeldItem;
+  // tskIDLE_PRIORITY for a mutex that only inherits.
+  UBaseType_t Ceiling;
+};
+
 typedef struct xMEMORY_REGION {
   void *Address;
   uint32_t NBytes;
@@ -144,6 +154,28 @@ TaskState TaskGetState(TaskHandle_t Task);
 
 void TaskPrioritySet(TaskHandle_t Task, UBaseType_t uxNewPriority);
 
+#if (configUSE_CORE_AFFINITY == 1)
+void TaskCoreAffinitySet(TaskHandle_t Task, UBaseType_t CoreAffinityMask);
+
+UBaseType_t TaskCoreAffinityGet(const TaskHandle_t Task);
+#endif
+
+#if (configUSE_EDF_SCHEDULING == 1)
+BaseType_t TaskSetDeadline(TaskHandle_t Task, TickType_t RelativeDeadline, TickType_t Period);
+
+UBaseType_t TaskGetDeadlineMisses(const TaskHandle_t Task);
+#endif
+
+#if (configUSE_TASK_BUDGETS == 1)
+BaseType_t TaskSetBudget(TaskHandle_t Task, TickType_t Budget, TickType_t Period);
+#endif
+
+#if (configUSE_TASK_TIME_SLICE == 1)
+void TaskSetTimeSlice(TaskHandle_t Task, TickType_t Ticks);
+
+TickType_t TaskGetTimeSlice(const TaskHandle_t Task);
+#endif
+
 void TaskSuspend(TaskHandle_t TaskToSuspend);
 
 void TaskResume(TaskHandle_t TaskToResume);
@@ -181,6 +213,15 @@ void ApplicationTickHook(void);
 void GetIdleTaskMemory(StaticTask_t **IdleTaskTCBBuffer, StackType_t **IdleTaskStackBuffer,
                        configSTACK_DEPTH_TYPE *puxIdleTaskStackSize);
 
+#if (configNUMBER_OF_CORES > 1)
+void GetPassiveIdleTaskMemory(StaticTask_t **IdleTaskTCBBuffer, StackType_t **IdleTaskStackBuffer,
+                              configSTACK_DEPTH_TYPE *puxIdleTaskStackSize, BaseType_t xPassiveIdleTaskIndex);
+#endif
+
+#if (configUSE_PASSIVE_IDLE_HOOK == 1)
+void ApplicationPassiveIdleHook(void);
+#endif
+
 BaseType_t GenericNotify(TaskHandle_t task, UBaseType_t idx, uint32_t value, eNotifyAction action, uint32_t *prevValue);
 #define TaskNotify(task, value, action) GenericNotify(task, tskDEFAULT_INDEX_TO_NOTIFY, value, action, NULL)
 #define TaskNotifyIndexed(task, idx, value, action) GenericNotify(task, idx, value, action, NULL)
@@ -237,6 +278,8 @@ BaseType_t CheckForTimeOut(TimeOut_t *const TimeOut, TickType_t *const ticks);
 
 BaseType_t CatchUpTicks(TickType_t xTicksToCatchUp);
 
+eSleepModeStatus TaskConfirmSleepModeStatus(void);
+
 void TaskResetState(void);
 
 #define taskYIELD_WITHIN_API() portYIELD_WITHIN_API()
@@ -248,7 +291,7 @@ void PlaceOnUnorderedEventList(List_t<TCB_t> *EventList, const TickType_t Value,
 
 void PlaceOnEventListRestricted(List_t<TCB_t> *const EventList, TickType_t xticks, const BaseType_t xWaitIndefinitely);
 
-BaseType_t RemoveFromEventList(const List_t<TCB_t> *const EventList);
+BaseType_t RemoveFromEventList(List_t<TCB_t> *const EventList);
 void RemoveFromUnorderedEventList(Item_t<TCB_t> *EventListItem, const TickType_t Value);
 
 portDONT_DISCARD void SwitchContext(void);
@@ -263,13 +306,30 @@ void MissedYield(void);
 
 BaseType_t GetSchedulerState(void);
 
-BaseType_t PriorityInherit(TaskHandle_t const pMutexHolder);
+BaseType_t PriorityInherit(MutexLink_t *const Mutex);
+
+BaseType_t PriorityDisinherit(MutexLink_t *const Mutex);
 
-BaseType_t PriorityDisinherit(TaskHandle_t const pMutexHolder);
+void PriorityDisinheritAfterTimeout(MutexLink_t *const Mutex);
 
-void PriorityDisinheritAfterTimeout(TaskHandle_t const pMutexHolder, UBaseType_t uxHighestPriorityWaitingTask);
+void MutexTaken(MutexLink_t *const Mutex);
 
-TaskHandle_t IncMutexHeldCount(void);
+void RequeueOnMutex(List_t<TCB_t> *const EventList, MutexLink_t *const Mutex);
+BaseType_t SignalFromEventList(List_t<TCB_t> *const EventList);
+BaseType_t TaskTakeSignal(void);
+
+#if (configUSE_MUTEX_FAST_PATH == 1)
+void MutexAdopt(MutexLink_t *const Mutex);
+#endif
+
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+BaseType_t TaskRunningElsewhere(const TaskHandle_t Task);
+#endif
+
+#if (configUSE_QUEUE_HANDOFF == 1)
+void *TaskSetHandoffBuffer(void *const Buffer);
+void *TaskTakeHandoffBuffer(List_t<TCB_t> *const EventList);
+#endif
 
 void SetTimeOutState(TimeOut_t *const TimeOut);
 void TaskEnterCritical(void);
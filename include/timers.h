@@ -27,7 +27,7 @@
  *
  */
 
-#include "freertos.h"
+#include "FreeRTOS.h"
 #include "task.hpp"
 #ifdef __cplusplus
 extern "C" {
@@ -0,0 +1,173 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "list.hpp"
+
+// Hierarchical timing wheel keyed on absolute tick values.
+//
+// Level L has 2^configTIMING_WHEEL_SLOT_BITS slots, each covering
+// 2^(L * configTIMING_WHEEL_SLOT_BITS) ticks. An item lives on the level of the
+// highest slot-sized digit in which its Value differs from Now, in the slot
+// given by that digit of its Value. Insert and remove are O(1), and the item
+// stays on an ordinary List_t so Item_t::remove() works unchanged. When Now
+// enters a slot on a level above zero, that slot is cascaded onto the lower
+// levels, so by the time Now reaches an item's Value the item sits in the level
+// zero slot that advance() returns.
+//
+// Tick wrap needs no special handling: the top level is a ring that covers the
+// whole tick range.
+template <class T>
+struct TimingWheel_t {
+  static constexpr unsigned SlotBits = configTIMING_WHEEL_SLOT_BITS;
+  static constexpr unsigned Slots = 1U << SlotBits;
+  static constexpr unsigned TickBits = sizeof(TickType_t) * 8U;
+  static constexpr unsigned Levels = (TickBits + SlotBits - 1U) / SlotBits;
+
+  TickType_t Now;
+  // Occupancy bits are set on insert but only cleared lazily, as items can be
+  // removed from their slot without the wheel knowing.
+  uint64_t Occupied[Levels];
+  List_t<T> Wheel[Levels][Slots];
+
+  void init(const TickType_t now) {
+    Now = now;
+    for (unsigned level = 0; level < Levels; level++) {
+      Occupied[level] = 0U;
+      for (unsigned slot = 0; slot < Slots; slot++) {
+        Wheel[level][slot].init();
+      }
+    }
+  }
+
+  bool contains(const List_t<T> *list) const { return list >= &Wheel[0][0] && list < &Wheel[0][0] + Levels * Slots; }
+
+  // An item due now would land in the slot that has already been expired, so
+  // it is pushed to the next tick like it would be on a sorted delayed list.
+  void insert(Item_t<T> *item) {
+    if (item->Value == Now) {
+      item->Value = Now + 1U;
+    }
+    place(item);
+  }
+
+  // Moves Now forward to `to`, which must not be past the earliest Value in the
+  // wheel, and returns the list of items whose Value is `to`.
+  List_t<T> *advance(const TickType_t to) {
+    if (to != Now) {
+      const TickType_t from = Now;
+      Now = to;
+      for (unsigned level = Levels - 1U; level > 0U; level--) {
+        const unsigned shift = level * SlotBits;
+        if ((from >> shift) != (to >> shift)) {
+          cascade(level, slotOf(to, level));
+        }
+      }
+    }
+    return &Wheel[0][slotOf(Now, 0)];
+  }
+
+  // Gives a lower bound on the earliest Value in the wheel: exact when it is on
+  // level zero, otherwise the first tick of its slot.
+  bool nextExpiry(TickType_t *when) {
+    bool found = false;
+    uint64_t best = 0U;
+    for (unsigned level = 0; level < Levels; level++) {
+      const unsigned shift = level * SlotBits;
+      const unsigned ring = slotsAt(level);
+      const unsigned start = (slotOf(Now, level) + 1U) % ring;
+      while (Occupied[level] != 0U) {
+        const uint64_t bits = Occupied[level];
+        const uint64_t rotated = (start == 0U) ? bits : ((bits >> start) | (bits << (ring - start)));
+        const unsigned ahead = (unsigned)__builtin_ctzll(rotated);
+        const unsigned slot = (start + ahead) % ring;
+        if (Wheel[level][slot].empty()) {
+          Occupied[level] &= ~((uint64_t)1U << slot);
+          continue;
+        }
+        const uint64_t span = (uint64_t)1U << shift;
+        const uint64_t distance = (uint64_t)(ahead + 1U) * span - ((uint64_t)Now & (span - 1U));
+        if (!found || distance < best) {
+          best = distance;
+          found = true;
+        }
+        break;
+      }
+    }
+    if (found) {
+      *when = (TickType_t)(Now + best);
+    }
+    return found;
+  }
+
+  bool empty() {
+    TickType_t when;
+    return !nextExpiry(&when);
+  }
+
+ private:
+  static constexpr unsigned slotsAt(const unsigned level) {
+    return (level + 1U < Levels) ? Slots : (1U << (TickBits - level * SlotBits));
+  }
+
+  static unsigned slotOf(const TickType_t value, const unsigned level) {
+    return (unsigned)(value >> (level * SlotBits)) & (Slots - 1U);
+  }
+
+  unsigned levelOf(const TickType_t value) const {
+    const TickType_t differs = value ^ Now;
+    unsigned level = Levels - 1U;
+    while (level > 0U && (differs >> (level * SlotBits)) == 0U) {
+      level--;
+    }
+    return level;
+  }
+
+  void place(Item_t<T> *item) {
+    const unsigned level = levelOf(item->Value);
+    const unsigned slot = slotOf(item->Value, level);
+    Wheel[level][slot].append(item);
+    Occupied[level] |= (uint64_t)1U << slot;
+  }
+
+  // Every item in the slot now shares that digit with Now, so each one moves
+  // to a lower level (or, for a Value a whole ring away, a higher one).
+  void cascade(const unsigned level, const unsigned slot) {
+    List_t<T> *const list = &Wheel[level][slot];
+    Occupied[level] &= ~((uint64_t)1U << slot);
+    while (!list->empty()) {
+      Item_t<T> *const item = list->head();
+      item->remove();
+      place(item);
+    }
+  }
+};
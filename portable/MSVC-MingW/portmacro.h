@@ -114,11 +114,8 @@ void vPortExitCritical( void );
 #endif
 
 #if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
-    /* Check the configuration. */
-    #if ( configMAX_PRIORITIES > 32 )
-        #error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
-    #endif
-    /* Store/clear the ready priorities in a bit map. */
+    /* Store/clear the ready priorities in a bit map.  The kernel splits the
+     * priorities into words of UBaseType_t, so these only ever see one word. */
     #define portRECORD_READY_PRIORITY( Priority, uxReadyPriorities )    ( uxReadyPriorities ) |= ( ( ( UBaseType_t ) 1 ) << ( Priority ) )
     #define portRESET_READY_PRIORITY( Priority, uxReadyPriorities )     ( uxReadyPriorities ) &= ~( ( ( UBaseType_t ) 1 ) << ( Priority ) )
     #ifdef __GNUC__
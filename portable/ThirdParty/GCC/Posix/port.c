@@ -0,0 +1,1030 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+/* Standard includes. */
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <time.h>
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.hpp"
+#include "utils/wait_for_event.h"
+
+/* The signal used to deliver the simulated tick interrupt to the thread of
+ * the task that is currently running. */
+#define portSIG_TICK                 SIGALRM
+/* The signal used to ask the thread running on another core to yield. */
+#define portSIG_YIELD                SIGUSR1
+#define portNO_CRITICAL_NESTING      ( ( UBaseType_t ) 0 )
+#define portNANOSECONDS_PER_SECOND   ( 1000000000L )
+
+/*
+ * Each task runs in its own pthread, but only the thread of the task that is
+ * in the Running state is ever allowed to execute - every other task thread is
+ * blocked on its own event.  A context switch is a direct hand-off: the thread
+ * being switched out signals the event of the thread being switched in, then
+ * waits on its own event.  There is no central thread that all yields and
+ * ticks have to go through, so a yield costs one futex wake and one futex wait.
+ *
+ * The tick is generated by a host thread that sends portSIG_TICK to the
+ * running task thread.  The signal handler runs the tick in the context of the
+ * interrupted task, exactly as a tick interrupt would on real hardware.  When
+ * configUSE_VIRTUAL_TIME is 1 there is no tick thread - the kernel advances
+ * the tick count itself whenever only the idle task can run.  When
+ * configUSE_TICKLESS_IDLE is 1 the idle task can ask the tick thread to sleep
+ * through a number of tick periods in one go, see
+ * vPortSuppressTicksAndSleep().
+ *
+ * When configNUMBER_OF_CORES is more than 1 each core is simulated by the
+ * thread of the task it is running, so up to configNUMBER_OF_CORES task
+ * threads execute at once.  A context switch hands the core over to the next
+ * thread exactly as above, and a yield is requested on another core by
+ * sending portSIG_YIELD to the thread running there.  The kernel's task and
+ * ISR locks are recursive spin locks owned by a core rather than by a thread,
+ * so they stay held across a context switch - the thread being switched out
+ * saves its nesting counts and the thread being switched in restores its own.
+ * Ticks are only taken by the thread running on core 0.
+ *
+ * Note that, as with any port that preempts host threads, a task can be
+ * switched out while it is inside a host library call that holds a lock (for
+ * example malloc() or printf()).  Calls like that should be made with the
+ * scheduler suspended or from within a critical section.
+ */
+typedef struct THREAD
+{
+    pthread_t pthread;
+    TaskFunction_t pxCode;
+    void * pvParams;
+    volatile BaseType_t xDying;
+    struct event * ev;
+    #if ( configNUMBER_OF_CORES > 1 )
+        BaseType_t xCore;
+        UBaseType_t uxTaskLockCount;
+        UBaseType_t uxISRLockCount;
+    #endif
+} Thread_t;
+
+#if ( configNUMBER_OF_CORES > 1 )
+    typedef struct CORE_LOCK
+    {
+        volatile BaseType_t xOwner;
+        volatile UBaseType_t uxCount;
+    } CoreLock_t;
+#endif
+
+/*
+ * The thread every task starts in.  It waits to be scheduled for the first
+ * time before calling the task function.
+ */
+static void * prvWaitForStart( void * pvParams );
+
+/*
+ * Created as a host thread, this function sends a tick signal to the running
+ * task thread once every tick period.
+ */
+static void * prvTimerTickHandler( void * pvParams );
+
+/*
+ * Handler for portSIG_TICK.  Processes the tick straight away if the running
+ * task is not inside a critical section, otherwise leaves it pending until
+ * the critical section is exited.
+ */
+static void prvTickSignalHandler( int sig );
+
+/*
+ * Runs TaskIncrementTick() once for every tick that is pending, switching to
+ * a different task if any of them requires it.
+ */
+static void prvProcessPendingTicks( void );
+
+/*
+ * Processes whatever simulated interrupts were held pending while the calling
+ * thread was inside a critical section.
+ */
+static void prvProcessPendingInterrupts( void );
+
+/*
+ * Stop the calling thread from being switched out while it is inside a host
+ * library call that takes an internal lock, without taking the kernel's
+ * locks.
+ */
+static void prvMaskInterrupts( void );
+static void prvUnmaskInterrupts( void );
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+/*
+ * Handler for portSIG_YIELD, and the yield it requests.
+ */
+    static void prvYieldSignalHandler( int sig );
+    static void prvProcessPendingYield( void );
+    static void prvStopSelf( void );
+    static void prvTakeLockForCore( CoreLock_t * pxLock,
+                                    BaseType_t xCore );
+    static void prvGetLock( CoreLock_t * pxLock );
+    static void prvGetTaskLock( void );
+    static void prvReleaseLock( CoreLock_t * pxLock );
+    static void prvRestoreLock( CoreLock_t * pxLock,
+                                UBaseType_t uxCount );
+#endif
+
+/*
+ * Select the next task to run and hand the processor over to its thread.
+ */
+static void prvYield( void );
+static void prvSwitchThread( Thread_t * pxThreadToResume,
+                             Thread_t * pxThreadToSuspend );
+static void prvSuspendSelf( Thread_t * pxThread );
+static void prvExitThread( void );
+static void prvSetupSignals( void );
+static void prvAddNanoseconds( struct timespec * pxTime,
+                               uint64_t ullNanoseconds );
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+/*
+ * Called by the tick thread when the idle task has asked it to sleep through
+ * xRequest ticks.  Sleeps until the tick the idle task expects to wake on,
+ * then wakes the idle task.
+ */
+    static void prvSleepThroughTicks( struct timespec * pxNextTick,
+                                      TickType_t xRequest );
+#endif
+
+/* The signals that represent simulated interrupts. */
+static sigset_t xInterruptSignals;
+static pthread_once_t hSigSetupThread = PTHREAD_ONCE_INIT;
+/* The threads of the tasks that are currently allowed to execute. */
+static Thread_t * volatile pxRunningThreads[ configNUMBER_OF_CORES ];
+/* Ticks generated by the tick thread that have not been processed yet. */
+static volatile uint32_t ulPendingTicks = 0U;
+static pthread_t hTimerTickThread;
+static volatile BaseType_t xTimerTickThreadShouldRun = false;
+/* Signalled by vPortEndScheduler() to let xPortStartScheduler() return. */
+static struct event * pxSchedulerEndEvent = NULL;
+/* Used to ensure nothing is processed during the startup sequence. */
+static volatile BaseType_t xPortRunning = false;
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+    /* The number of ticks the idle task wants to sleep through, taken by the
+     * tick thread at the next tick, and the number it really slept through. */
+    static volatile TickType_t xTicklessRequest = 0U;
+    static volatile TickType_t xTicklessElapsed = 0U;
+    static struct event * pxTicklessWakeEvent = NULL;
+#endif
+
+#if ( configNUMBER_OF_CORES > 1 )
+    static CoreLock_t xTaskLock = { -1, 0U };
+    static CoreLock_t xISRLock = { -1, 0U };
+    /* Set by vPortYieldCore() before it signals the core. */
+    static volatile BaseType_t xYieldRequested[ configNUMBER_OF_CORES ];
+    /* Set by vPortEndScheduler() to stop the threads running on the other
+     * cores, which count themselves in as they stop. */
+    static volatile BaseType_t xPortEnding = false;
+    static volatile UBaseType_t uxStoppedCores = 0U;
+#endif
+
+/* The critical nesting count and the Thread_t of the calling host thread.
+ * Only the running task thread ever changes its nesting count, so there is
+ * no need to save and restore it across a context switch. */
+static __thread volatile UBaseType_t uxCriticalNesting = portNO_CRITICAL_NESTING;
+static __thread Thread_t * pxThisThread = NULL;
+/* Where the thread of a deleted task jumps to in order to exit. */
+static __thread sigjmp_buf xThreadExitJump;
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+/* The kernel locks are only taken by task threads once the scheduler is
+ * running - before then the only thread is the one creating the tasks. */
+    static BaseType_t prvLocksInUse( void )
+    {
+        return ( xPortRunning != false ) && ( pxThisThread != NULL );
+    }
+#endif
+
+static Thread_t * prvGetThreadFromTask( TaskHandle_t xTask )
+{
+    /* The first member of the TCB is the top of stack pointer, which in this
+     * port points to the Thread_t of the task. */
+    return ( Thread_t * ) *( ( StackType_t ** ) xTask );
+}
+
+static void prvSetupSignals( void )
+{
+    struct sigaction xSigTick;
+
+    sigemptyset( &xInterruptSignals );
+    sigaddset( &xInterruptSignals, portSIG_TICK );
+
+    xSigTick.sa_flags = SA_RESTART;
+    xSigTick.sa_handler = prvTickSignalHandler;
+    sigfillset( &xSigTick.sa_mask );
+    ( void ) sigaction( portSIG_TICK, &xSigTick, NULL );
+
+    #if ( configNUMBER_OF_CORES > 1 )
+    {
+        struct sigaction xSigYield;
+
+        sigaddset( &xInterruptSignals, portSIG_YIELD );
+
+        xSigYield.sa_flags = SA_RESTART;
+        xSigYield.sa_handler = prvYieldSignalHandler;
+        sigfillset( &xSigYield.sa_mask );
+        ( void ) sigaction( portSIG_YIELD, &xSigYield, NULL );
+    }
+    #endif
+}
+
+StackType_t * PortInitialiseStack( StackType_t * StackTop,
+                                   TaskFunction_t Code,
+                                   void * Params )
+{
+    Thread_t * pxThread;
+    sigset_t xSavedSignals;
+    int iRet;
+
+    ( void ) pthread_once( &hSigSetupThread, prvSetupSignals );
+
+    /* As in the Windows port the stack is not initialised, instead a thread
+     * is created that will execute the task being created.  The Thread_t
+     * object is placed onto the stack that was created for the task, which
+     * is then not used for anything other than holding this structure. */
+    pxThread = ( Thread_t * ) ( ( ( int8_t * ) StackTop ) - sizeof( Thread_t ) );
+    pxThread->pxCode = Code;
+    pxThread->pvParams = Params;
+    pxThread->xDying = false;
+    prvMaskInterrupts();
+    pxThread->ev = event_create();
+    #if ( configNUMBER_OF_CORES > 1 )
+        pxThread->xCore = 0;
+        pxThread->uxTaskLockCount = 0U;
+        pxThread->uxISRLockCount = 0U;
+    #endif
+
+    /* The new thread must not take a tick before it is scheduled for the
+     * first time, so it is created with the tick signal masked. */
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, &xSavedSignals );
+    iRet = pthread_create( &pxThread->pthread, NULL, prvWaitForStart, pxThread );
+    pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+    prvUnmaskInterrupts();
+
+    if( iRet != 0 )
+    {
+        fprintf( stderr, "PortInitialiseStack: pthread_create() failed (%d)\n", iRet );
+        abort();
+    }
+
+    return ( StackType_t * ) pxThread;
+}
+
+static void * prvWaitForStart( void * pvParams )
+{
+    Thread_t * pxThread = ( Thread_t * ) pvParams;
+
+    pxThisThread = pxThread;
+
+    if( sigsetjmp( xThreadExitJump, 0 ) == 0 )
+    {
+        prvSuspendSelf( pxThread );
+
+        /* Scheduled for the first time - enable (simulated) interrupts. */
+        uxCriticalNesting = portNO_CRITICAL_NESTING;
+        pthread_sigmask( SIG_UNBLOCK, &xInterruptSignals, NULL );
+        prvProcessPendingInterrupts();
+
+        pxThread->pxCode( pxThread->pvParams );
+
+        /* A function that implements a task must not return, but if it does
+         * the task is deleted rather than leaving the thread in an unknown
+         * state. */
+        TaskDelete( NULL );
+    }
+
+    return NULL;
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+    BaseType_t xCore;
+
+    ( void ) pthread_once( &hSigSetupThread, prvSetupSignals );
+
+    /* This thread never runs a task, so it must never take a tick.  The tick
+     * thread created below inherits the mask. */
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+
+    pxSchedulerEndEvent = event_create();
+    #if ( configUSE_TICKLESS_IDLE != 0 )
+        pxTicklessWakeEvent = event_create();
+    #endif
+    for( xCore = 0; xCore < configNUMBER_OF_CORES; xCore++ )
+    {
+        pxRunningThreads[ xCore ] = prvGetThreadFromTask( GetCurrentTaskHandleForCore( xCore ) );
+        #if ( configNUMBER_OF_CORES > 1 )
+            pxRunningThreads[ xCore ]->xCore = xCore;
+        #endif
+    }
+
+    ulPendingTicks = 0U;
+
+    /* The scheduler is now running. */
+    xPortRunning = true;
+
+    #if ( configUSE_VIRTUAL_TIME == 0 )
+    {
+        xTimerTickThreadShouldRun = true;
+
+        if( pthread_create( &hTimerTickThread, NULL, prvTimerTickHandler, NULL ) != 0 )
+        {
+            xPortRunning = false;
+            event_delete( pxSchedulerEndEvent );
+            pxSchedulerEndEvent = NULL;
+            return false;
+        }
+    }
+    #endif /* configUSE_VIRTUAL_TIME */
+
+    /* Start the first task on each core. */
+    #if ( configNUMBER_OF_CORES == 1 )
+    {
+        event_signal( pxRunningThreads[ 0 ]->ev );
+    }
+    #else
+    {
+        /* A first thread releases the locks held by the thread it took its
+         * core from, so the locks are taken on behalf of each core in turn,
+         * waiting for the previous core to have started. */
+        for( xCore = 0; xCore < configNUMBER_OF_CORES; xCore++ )
+        {
+            prvTakeLockForCore( &xTaskLock, xCore );
+            prvTakeLockForCore( &xISRLock, xCore );
+            event_signal( pxRunningThreads[ xCore ]->ev );
+        }
+    }
+    #endif /* configNUMBER_OF_CORES */
+
+    /* Wait here until vPortEndScheduler() is called from a task. */
+    event_wait( pxSchedulerEndEvent );
+
+    #if ( configUSE_VIRTUAL_TIME == 0 )
+    {
+        xTimerTickThreadShouldRun = false;
+        ( void ) pthread_join( hTimerTickThread, NULL );
+    }
+    #endif /* configUSE_VIRTUAL_TIME */
+
+    event_delete( pxSchedulerEndEvent );
+    pxSchedulerEndEvent = NULL;
+
+    for( xCore = 0; xCore < configNUMBER_OF_CORES; xCore++ )
+    {
+        pxRunningThreads[ xCore ] = NULL;
+    }
+
+    #if ( configUSE_TICKLESS_IDLE != 0 )
+        event_delete( pxTicklessWakeEvent );
+        pxTicklessWakeEvent = NULL;
+    #endif
+
+    return 0;
+}
+
+void vPortEndScheduler( void )
+{
+    #if ( configNUMBER_OF_CORES > 1 )
+    {
+        BaseType_t xCore;
+
+        /* The threads running on the other cores would otherwise carry on
+         * running tasks after xPortStartScheduler() has returned. */
+        __atomic_store_n( &xPortEnding, true, __ATOMIC_RELEASE );
+
+        for( xCore = 0; xCore < configNUMBER_OF_CORES; xCore++ )
+        {
+            if( ( pxRunningThreads[ xCore ] != NULL ) && ( pxRunningThreads[ xCore ] != pxThisThread ) )
+            {
+                ( void ) pthread_kill( pxRunningThreads[ xCore ]->pthread, portSIG_YIELD );
+            }
+        }
+
+        while( __atomic_load_n( &uxStoppedCores, __ATOMIC_ACQUIRE ) < ( UBaseType_t ) ( configNUMBER_OF_CORES - 1 ) )
+        {
+            sched_yield();
+        }
+    }
+    #endif /* configNUMBER_OF_CORES */
+
+    xPortRunning = false;
+    xTimerTickThreadShouldRun = false;
+
+    if( pxSchedulerEndEvent != NULL )
+    {
+        event_signal( pxSchedulerEndEvent );
+    }
+
+    /* If called from a task then that task's thread must not continue to run
+     * alongside the thread that called xPortStartScheduler(). */
+    if( pxThisThread != NULL )
+    {
+        for( ; ; )
+        {
+            prvSuspendSelf( pxThisThread );
+        }
+    }
+}
+
+static void * prvTimerTickHandler( void * pvParams )
+{
+    struct timespec xNextTick;
+    Thread_t * pxThread;
+
+    ( void ) pvParams;
+    clock_gettime( CLOCK_MONOTONIC, &xNextTick );
+
+    while( xTimerTickThreadShouldRun )
+    {
+        /* Sleep until an absolute time so the tick does not drift by the time
+         * it takes to deliver each signal. */
+        prvAddNanoseconds( &xNextTick, ( uint64_t ) portTICK_RATE_MICROSECONDS * 1000U );
+        ( void ) clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNextTick, NULL );
+
+        #if ( configUSE_TICKLESS_IDLE != 0 )
+        {
+            TickType_t xRequest = __atomic_exchange_n( &xTicklessRequest, 0U, __ATOMIC_ACQ_REL );
+
+            if( xRequest != 0U )
+            {
+                prvSleepThroughTicks( &xNextTick, xRequest );
+                continue;
+            }
+        }
+        #endif /* configUSE_TICKLESS_IDLE */
+
+        /* The tick is counted before it is signalled, so it is never lost if
+         * the thread it is sent to has been switched out in the meantime -
+         * whichever task thread runs next picks it up. */
+        __atomic_fetch_add( &ulPendingTicks, 1U, __ATOMIC_RELEASE );
+        pxThread = pxRunningThreads[ 0 ];
+
+        if( ( pxThread != NULL ) && xTimerTickThreadShouldRun )
+        {
+            ( void ) pthread_kill( pxThread->pthread, portSIG_TICK );
+        }
+    }
+
+    return NULL;
+}
+
+static void prvAddNanoseconds( struct timespec * pxTime,
+                               uint64_t ullNanoseconds )
+{
+    ullNanoseconds += ( uint64_t ) pxTime->tv_nsec;
+    pxTime->tv_sec += ( time_t ) ( ullNanoseconds / ( uint64_t ) portNANOSECONDS_PER_SECOND );
+    pxTime->tv_nsec = ( long ) ( ullNanoseconds % ( uint64_t ) portNANOSECONDS_PER_SECOND );
+}
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+    static void prvSleepThroughTicks( struct timespec * pxNextTick,
+                                      TickType_t xRequest )
+    {
+        uint32_t ulPending;
+        TickType_t xTicks;
+
+        /* The tick just reached is the first one slept through.  Ticks that
+         * became pending after the idle task calculated xRequest have already
+         * passed, so are not slept through a second time. */
+        ulPending = __atomic_load_n( &ulPendingTicks, __ATOMIC_ACQUIRE );
+        xTicks = ( xRequest > ( TickType_t ) ulPending + 1U ) ? ( TickType_t ) ( xRequest - ulPending ) : 1U;
+
+        if( xTicks > 1U )
+        {
+            prvAddNanoseconds( pxNextTick, ( uint64_t ) ( xTicks - 1U ) * portTICK_RATE_MICROSECONDS * 1000U );
+            ( void ) clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, pxNextTick, NULL );
+        }
+
+        xTicklessElapsed = xTicks;
+        event_signal( pxTicklessWakeEvent );
+    }
+
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+        /* Ticks stay pending while the idle task sleeps, and nothing else can
+         * make a task ready, so the sleep cannot end early. */
+        vPortEnterCritical();
+
+        if( ( TaskConfirmSleepModeStatus() != eAbortSleep ) &&
+            ( __atomic_load_n( &ulPendingTicks, __ATOMIC_ACQUIRE ) == 0U ) )
+        {
+            __atomic_store_n( &xTicklessRequest, xExpectedIdleTime, __ATOMIC_RELEASE );
+            event_wait( pxTicklessWakeEvent );
+            ( void ) CatchUpTicks( xTicklessElapsed );
+        }
+
+        vPortExitCritical();
+    }
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+static void prvTickSignalHandler( int sig )
+{
+    ( void ) sig;
+
+    /* Inside a critical section interrupts are (simulated as) disabled, so
+     * the tick stays pending until vPortExitCritical() processes it. */
+    if( uxCriticalNesting == portNO_CRITICAL_NESTING )
+    {
+        prvProcessPendingTicks();
+    }
+}
+
+static void prvProcessPendingTicks( void )
+{
+    uint32_t ulTicks;
+    BaseType_t xSwitchRequired = false;
+
+    /* Only the running task thread processes ticks.  This also stops a thread
+     * that is exiting after its task was deleted from touching the kernel. */
+    if( ( xPortRunning == false ) || ( pxThisThread == NULL ) || ( pxThisThread != pxRunningThreads[ 0 ] ) )
+    {
+        return;
+    }
+
+    uxCriticalNesting++;
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        /* Like a tick interrupt, the tick only needs the ISR lock. */
+        prvGetLock( &xISRLock );
+    #endif
+
+    for( ulTicks = __atomic_exchange_n( &ulPendingTicks, 0U, __ATOMIC_ACQUIRE ); ulTicks > 0U; ulTicks-- )
+    {
+        if( TaskIncrementTick() != false )
+        {
+            xSwitchRequired = true;
+        }
+    }
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        prvReleaseLock( &xISRLock );
+
+        if( xSwitchRequired != false )
+        {
+            prvGetLock( &xTaskLock );
+            prvGetLock( &xISRLock );
+            prvYield();
+            prvReleaseLock( &xISRLock );
+            prvReleaseLock( &xTaskLock );
+        }
+    #else
+        if( xSwitchRequired != false )
+        {
+            prvYield();
+        }
+    #endif
+
+    uxCriticalNesting--;
+}
+
+static void prvMaskInterrupts( void )
+{
+    uxCriticalNesting++;
+    portSOFTWARE_BARRIER();
+}
+
+static void prvUnmaskInterrupts( void )
+{
+    portSOFTWARE_BARRIER();
+    uxCriticalNesting--;
+
+    if( uxCriticalNesting == portNO_CRITICAL_NESTING )
+    {
+        prvProcessPendingInterrupts();
+    }
+}
+
+static void prvProcessPendingInterrupts( void )
+{
+    if( __atomic_load_n( &ulPendingTicks, __ATOMIC_RELAXED ) != 0U )
+    {
+        prvProcessPendingTicks();
+    }
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        prvProcessPendingYield();
+    #endif
+}
+
+static void prvYield( void )
+{
+    Thread_t * pxThreadToSuspend;
+    Thread_t * pxThreadToResume;
+
+    pxThreadToSuspend = prvGetThreadFromTask( CurrentTaskHandle() );
+    SwitchContext();
+    pxThreadToResume = prvGetThreadFromTask( CurrentTaskHandle() );
+    prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+}
+
+static void prvSwitchThread( Thread_t * pxThreadToResume,
+                             Thread_t * pxThreadToSuspend )
+{
+    if( pxThreadToSuspend != pxThreadToResume )
+    {
+        #if ( configNUMBER_OF_CORES > 1 )
+        {
+            /* The locks stay with the core, the thread being switched in
+             * restores its own nesting of them. */
+            pxThreadToSuspend->uxTaskLockCount = xTaskLock.uxCount;
+            pxThreadToSuspend->uxISRLockCount = xISRLock.uxCount;
+            pxThreadToResume->xCore = pxThreadToSuspend->xCore;
+            pxRunningThreads[ pxThreadToSuspend->xCore ] = pxThreadToResume;
+        }
+        #else
+        {
+            pxRunningThreads[ 0 ] = pxThreadToResume;
+        }
+        #endif
+        event_signal( pxThreadToResume->ev );
+
+        if( pxThreadToSuspend->xDying != false )
+        {
+            prvExitThread();
+        }
+
+        prvSuspendSelf( pxThreadToSuspend );
+    }
+}
+
+static void prvSuspendSelf( Thread_t * pxThread )
+{
+    ( void ) event_wait( pxThread->ev );
+
+    /* A task that was deleted while its thread was switched out is woken one
+     * last time by vPortCancelThread() so its thread can exit.  With more
+     * than one core a task can also be deleted after its core has been given
+     * to it but before its thread got to run, in which case the thread runs
+     * until it takes the yield the deletion asked for. */
+    #if ( configNUMBER_OF_CORES > 1 )
+        if( ( pxThread->xDying != false ) && ( pxRunningThreads[ pxThread->xCore ] != pxThread ) )
+    #else
+        if( pxThread->xDying != false )
+    #endif
+    {
+        prvExitThread();
+    }
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        prvRestoreLock( &xTaskLock, pxThread->uxTaskLockCount );
+        prvRestoreLock( &xISRLock, pxThread->uxISRLockCount );
+    #endif
+}
+
+static void prvExitThread( void )
+{
+    /* pthread_exit() would unwind the C++ frames of the task, which can
+     * include the frame of the tick signal handler, so jump straight back to
+     * prvWaitForStart() and return from the thread function instead.  None of
+     * the frames being discarded hold anything the thread still needs. */
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+    siglongjmp( xThreadExitJump, 1 );
+}
+
+void vPortYield( void )
+{
+    if( ( xPortRunning == false ) || ( pxThisThread == NULL ) )
+    {
+        return;
+    }
+
+    vPortEnterCritical();
+    prvYield();
+    vPortExitCritical();
+}
+
+void vPortThreadDying( void * TaskToDelete,
+                       volatile BaseType_t * PendYield )
+{
+    /* The thread exits as soon as it has handed the processor over to the
+     * next task in prvSwitchThread(). */
+    prvGetThreadFromTask( ( TaskHandle_t ) TaskToDelete )->xDying = true;
+    *PendYield = true;
+}
+
+void vPortCancelThread( void * TaskToDelete )
+{
+    Thread_t * pxThread = prvGetThreadFromTask( ( TaskHandle_t ) TaskToDelete );
+
+    /* The thread is blocked on its event (or has already exited), so it is
+     * woken with xDying set and then joined before its stack is freed. */
+    pxThread->xDying = true;
+
+    if( pthread_equal( pxThread->pthread, pthread_self() ) == 0 )
+    {
+        prvMaskInterrupts();
+        event_signal( pxThread->ev );
+        ( void ) pthread_join( pxThread->pthread, NULL );
+        event_delete( pxThread->ev );
+        prvUnmaskInterrupts();
+    }
+}
+
+void vPortDisableInterrupts( void )
+{
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+}
+
+void vPortEnableInterrupts( void )
+{
+    pthread_sigmask( SIG_UNBLOCK, &xInterruptSignals, NULL );
+}
+
+void vPortEnterCritical( void )
+{
+    /* No system call is needed to (simulate) disabling interrupts - the tick
+     * signal handler checks the nesting count of the thread it interrupts. */
+    uxCriticalNesting++;
+    portSOFTWARE_BARRIER();
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        if( prvLocksInUse() != false )
+        {
+            prvGetTaskLock();
+            prvGetLock( &xISRLock );
+        }
+    #endif
+}
+
+void vPortExitCritical( void )
+{
+    portSOFTWARE_BARRIER();
+
+    if( uxCriticalNesting > portNO_CRITICAL_NESTING )
+    {
+        #if ( configNUMBER_OF_CORES > 1 )
+            if( prvLocksInUse() != false )
+            {
+                prvReleaseLock( &xISRLock );
+                prvReleaseLock( &xTaskLock );
+            }
+        #endif
+
+        uxCriticalNesting--;
+
+        /* Process any tick that was held pending while interrupts were
+         * (simulated as) disabled. */
+        if( uxCriticalNesting == portNO_CRITICAL_NESTING )
+        {
+            prvProcessPendingInterrupts();
+        }
+    }
+}
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+    BaseType_t xPortGetCoreID( void )
+    {
+        /* The thread that starts the scheduler runs on core 0 until then. */
+        return ( pxThisThread != NULL ) ? pxThisThread->xCore : 0;
+    }
+
+    void vPortYieldCore( BaseType_t xCoreID )
+    {
+        Thread_t * pxThread;
+
+        if( xCoreID == xPortGetCoreID() )
+        {
+            vPortYield();
+        }
+        else
+        {
+            /* The flag outlives the signal, so if the core switches threads
+             * before the signal arrives the next thread still yields when it
+             * leaves its critical section. */
+            __atomic_store_n( &xYieldRequested[ xCoreID ], true, __ATOMIC_RELEASE );
+            pxThread = pxRunningThreads[ xCoreID ];
+
+            if( pxThread != NULL )
+            {
+                ( void ) pthread_kill( pxThread->pthread, portSIG_YIELD );
+            }
+        }
+    }
+
+    static void prvYieldSignalHandler( int sig )
+    {
+        ( void ) sig;
+
+        if( uxCriticalNesting == portNO_CRITICAL_NESTING )
+        {
+            prvProcessPendingYield();
+        }
+    }
+
+    static void prvProcessPendingYield( void )
+    {
+        BaseType_t xCore;
+
+        if( ( xPortRunning == false ) || ( pxThisThread == NULL ) )
+        {
+            return;
+        }
+
+        if( __atomic_load_n( &xPortEnding, __ATOMIC_ACQUIRE ) != false )
+        {
+            prvStopSelf();
+        }
+
+        xCore = pxThisThread->xCore;
+
+        if( ( pxRunningThreads[ xCore ] == pxThisThread ) &&
+            ( __atomic_exchange_n( &xYieldRequested[ xCore ], false, __ATOMIC_ACQ_REL ) != false ) )
+        {
+            vPortYield();
+        }
+    }
+
+    static void prvTakeLockForCore( CoreLock_t * pxLock,
+                                    BaseType_t xCore )
+    {
+        BaseType_t xFree = -1;
+
+        /* Only the thread running on a core can find the lock owned by that
+         * core, so a plain load is enough to detect a recursive take. */
+        if( __atomic_load_n( &pxLock->xOwner, __ATOMIC_ACQUIRE ) != xCore )
+        {
+            while( !__atomic_compare_exchange_n( &pxLock->xOwner, &xFree, xCore, false,
+                                                 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) )
+            {
+                xFree = -1;
+
+                /* The owner may have stopped while holding the lock. */
+                if( ( pxThisThread != NULL ) && ( __atomic_load_n( &xPortEnding, __ATOMIC_ACQUIRE ) != false ) )
+                {
+                    prvStopSelf();
+                }
+
+                sched_yield();
+            }
+        }
+
+        pxLock->uxCount++;
+    }
+
+    static void prvStopSelf( void )
+    {
+        __atomic_fetch_add( &uxStoppedCores, 1U, __ATOMIC_RELEASE );
+
+        for( ; ; )
+        {
+            prvSuspendSelf( pxThisThread );
+        }
+    }
+
+    static void prvGetLock( CoreLock_t * pxLock )
+    {
+        prvTakeLockForCore( pxLock, pxThisThread->xCore );
+    }
+
+    static void prvGetTaskLock( void )
+    {
+        BaseType_t xCore;
+
+        prvGetLock( &xTaskLock );
+
+        /* Another core may have asked this core to yield while it waited for
+         * the lock, for example because it deleted or suspended the task
+         * running here.  That task must not run any more kernel code, so the
+         * yield is taken now rather than when the signal is handled, which
+         * may be too late if the scheduler is about to be suspended. */
+        if( xTaskLock.uxCount == 1U )
+        {
+            for( xCore = pxThisThread->xCore;
+                 __atomic_exchange_n( &xYieldRequested[ xCore ], false, __ATOMIC_ACQ_REL ) != false;
+                 xCore = pxThisThread->xCore )
+            {
+                prvGetLock( &xISRLock );
+                prvYield();
+                prvReleaseLock( &xISRLock );
+            }
+        }
+    }
+
+    static void prvReleaseLock( CoreLock_t * pxLock )
+    {
+        pxLock->uxCount--;
+
+        if( pxLock->uxCount == 0U )
+        {
+            __atomic_store_n( &pxLock->xOwner, -1, __ATOMIC_RELEASE );
+        }
+    }
+
+    static void prvRestoreLock( CoreLock_t * pxLock,
+                                UBaseType_t uxCount )
+    {
+        pxLock->uxCount = uxCount;
+
+        if( uxCount == 0U )
+        {
+            __atomic_store_n( &pxLock->xOwner, -1, __ATOMIC_RELEASE );
+        }
+    }
+
+    void vPortGetTaskLock( void )
+    {
+        if( prvLocksInUse() != false )
+        {
+            prvGetTaskLock();
+        }
+    }
+
+    void vPortReleaseTaskLock( void )
+    {
+        if( prvLocksInUse() != false )
+        {
+            prvReleaseLock( &xTaskLock );
+        }
+    }
+
+    void vPortGetISRLock( void )
+    {
+        if( prvLocksInUse() != false )
+        {
+            prvGetLock( &xISRLock );
+        }
+    }
+
+    void vPortReleaseISRLock( void )
+    {
+        if( prvLocksInUse() != false )
+        {
+            prvReleaseLock( &xISRLock );
+        }
+    }
+
+    UBaseType_t uxPortSetInterruptMask( void )
+    {
+        prvMaskInterrupts();
+
+        return 0U;
+    }
+
+    void vPortClearInterruptMask( UBaseType_t uxSavedStatus )
+    {
+        ( void ) uxSavedStatus;
+        prvUnmaskInterrupts();
+    }
+
+    UBaseType_t uxPortEnterCriticalFromISR( void )
+    {
+        UBaseType_t uxSavedStatus = uxPortSetInterruptMask();
+
+        if( prvLocksInUse() != false )
+        {
+            prvGetLock( &xISRLock );
+        }
+
+        return uxSavedStatus;
+    }
+
+    void vPortExitCriticalFromISR( UBaseType_t uxSavedStatus )
+    {
+        if( prvLocksInUse() != false )
+        {
+            prvReleaseLock( &xISRLock );
+        }
+
+        vPortClearInterruptMask( uxSavedStatus );
+    }
+
+#endif /* configNUMBER_OF_CORES > 1 */
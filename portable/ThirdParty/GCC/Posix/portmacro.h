@@ -0,0 +1,162 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+#pragma once
+#include <limits.h>
+#include <stdint.h>
+
+/******************************************************************************
+*   Defines
+******************************************************************************/
+/* Type definitions. */
+#define portCHAR                 char
+#define portFLOAT                float
+#define portDOUBLE               double
+#define portLONG                 long
+#define portSHORT                short
+#define portSTACK_TYPE           unsigned long
+#define portBASE_TYPE            long
+#define portPOINTER_SIZE_TYPE    size_t
+typedef portSTACK_TYPE           StackType_t;
+typedef long                     BaseType_t;
+typedef unsigned long            UBaseType_t;
+
+#if ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
+    typedef uint16_t             TickType_t;
+    #define portMAX_DELAY              ( TickType_t ) 0xffff
+#elif ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_32_BITS )
+    typedef uint32_t             TickType_t;
+    #define portMAX_DELAY              ( TickType_t ) 0xffffffffUL
+/* 32-bit tick type on a 32/64-bit architecture, so reads of the tick
+ * count do not need to be guarded with a critical section. */
+    #define portTICK_TYPE_IS_ATOMIC    1
+#elif ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_64_BITS )
+    typedef uint64_t             TickType_t;
+    #define portMAX_DELAY              ( TickType_t ) 0xffffffffffffffffULL
+#if ( ULONG_MAX == 0xffffffffffffffffUL )
+/* 64-bit tick type on a 64-bit architecture, so reads of the tick
+ * count do not need to be guarded with a critical section. */
+    #define portTICK_TYPE_IS_ATOMIC    1
+#endif
+#else
+    #error configTICK_TYPE_WIDTH_IN_BITS set to unsupported tick type width.
+#endif
+/* Hardware specifics. */
+#define portSTACK_GROWTH          ( -1 )
+#define portHAS_STACK_OVERFLOW_CHECKING    ( 0 )
+#define portTICK_PERIOD_MS        ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portTICK_RATE_MICROSECONDS    ( ( TickType_t ) 1000000 / configTICK_RATE_HZ )
+#define portINLINE                __inline
+#if ( ULONG_MAX == 0xffffffffffffffffUL )
+    #define portBYTE_ALIGNMENT    8
+    #define portBITS_PER_BASE_TYPE    64
+#else
+    #define portBYTE_ALIGNMENT    4
+    #define portBITS_PER_BASE_TYPE    32
+#endif
+
+/* Scheduler utilities.  There is no central thread processing simulated
+ * interrupts in this port: a yield switches directly from the thread of the
+ * task being switched out to the thread of the task being switched in. */
+void vPortYield( void );
+#define portYIELD()    vPortYield()
+
+#define portYIELD_FROM_ISR( x )       do { if( ( x ) != 0 ) { vPortYield(); } } while( 0 )
+#define portEND_SWITCHING_ISR( x )    portYIELD_FROM_ISR( ( x ) )
+
+void vPortThreadDying( void * TaskToDelete,
+                       volatile BaseType_t * PendYield );
+void vPortCancelThread( void * TaskToDelete );
+#define portCLEAN_UP_TCB( TCB )                                  vPortCancelThread( TCB )
+#define portPRE_TASK_DELETE_HOOK( TaskToDelete, PendYield )    vPortThreadDying( ( TaskToDelete ), ( PendYield ) )
+
+/* Interrupts are simulated with signals, so disabling interrupts masks all
+ * signals for the calling thread. */
+void vPortDisableInterrupts( void );
+void vPortEnableInterrupts( void );
+#define portDISABLE_INTERRUPTS()    vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()     vPortEnableInterrupts()
+
+/* Tickless idle support. */
+#if ( configUSE_TICKLESS_IDLE != 0 )
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+    #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+
+/* Critical section handling. */
+void vPortEnterCritical( void );
+void vPortExitCritical( void );
+#define portENTER_CRITICAL()    vPortEnterCritical()
+#define portEXIT_CRITICAL()     vPortExitCritical()
+
+#if ( configNUMBER_OF_CORES > 1 )
+    /* Each core is simulated by the thread of the task it is running.  A
+     * critical section takes both kernel locks, an ISR critical section only
+     * takes the ISR lock. */
+    #if ( configUSE_TICKLESS_IDLE != 0 )
+        #error configUSE_TICKLESS_IDLE is not supported when configNUMBER_OF_CORES is more than 1.
+    #endif
+    BaseType_t xPortGetCoreID( void );
+    void vPortYieldCore( BaseType_t xCoreID );
+    void vPortGetTaskLock( void );
+    void vPortReleaseTaskLock( void );
+    void vPortGetISRLock( void );
+    void vPortReleaseISRLock( void );
+    UBaseType_t uxPortSetInterruptMask( void );
+    void vPortClearInterruptMask( UBaseType_t uxSavedStatus );
+    UBaseType_t uxPortEnterCriticalFromISR( void );
+    void vPortExitCriticalFromISR( UBaseType_t uxSavedStatus );
+    #define portGET_CORE_ID()                              xPortGetCoreID()
+    #define portYIELD_CORE( xCoreID )                      vPortYieldCore( xCoreID )
+    #define portGET_TASK_LOCK()                            vPortGetTaskLock()
+    #define portRELEASE_TASK_LOCK()                        vPortReleaseTaskLock()
+    #define portGET_ISR_LOCK()                             vPortGetISRLock()
+    #define portRELEASE_ISR_LOCK()                         vPortReleaseISRLock()
+    #define portSET_INTERRUPT_MASK()                       uxPortSetInterruptMask()
+    #define portCLEAR_INTERRUPT_MASK( uxSavedStatus )      vPortClearInterruptMask( uxSavedStatus )
+    #define portSET_INTERRUPT_MASK_FROM_ISR()              uxPortEnterCriticalFromISR()
+    #define portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedStatus )    vPortExitCriticalFromISR( uxSavedStatus )
+#endif
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+    #define configUSE_PORT_OPTIMISED_TASK_SELECTION    1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+    /* Store/clear the ready priorities in a bit map.  The kernel splits the
+     * priorities into words of UBaseType_t, so these only ever see one word. */
+    #define portRECORD_READY_PRIORITY( Priority, uxReadyPriorities )    ( uxReadyPriorities ) |= ( ( ( UBaseType_t ) 1 ) << ( Priority ) )
+    #define portRESET_READY_PRIORITY( Priority, uxReadyPriorities )     ( uxReadyPriorities ) &= ~( ( ( UBaseType_t ) 1 ) << ( Priority ) )
+    #define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities )    uxTopPriority = ( ( portBITS_PER_BASE_TYPE - 1 ) - __builtin_clzl( ( uxReadyPriorities ) ) )
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, Params )    void vFunction( void * Params )
+#define portTASK_FUNCTION( vFunction, Params )          void vFunction( void * Params )
+
+#define portSOFTWARE_BARRIER()    __asm volatile ( "" ::: "memory" )
+#define portMEMORY_BARRIER()      __sync_synchronize()
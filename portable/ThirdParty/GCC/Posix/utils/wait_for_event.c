@@ -0,0 +1,91 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+#include <linux/futex.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "wait_for_event.h"
+
+/* The event is a single futex word, so an uncontended signal or wait is one
+ * atomic operation, and a contended one is a single system call.  There is no
+ * pthread mutex involved, which keeps the hand-off between two task threads as
+ * short as the host allows. */
+struct event
+{
+    uint32_t ulTriggered;
+};
+
+static void prvFutexWait( uint32_t * pulWord,
+                          uint32_t ulExpected )
+{
+    ( void ) syscall( SYS_futex, pulWord, FUTEX_WAIT_PRIVATE, ulExpected, NULL, NULL, 0 );
+}
+
+static void prvFutexWake( uint32_t * pulWord )
+{
+    ( void ) syscall( SYS_futex, pulWord, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+}
+
+struct event * event_create( void )
+{
+    struct event * ev = ( struct event * ) malloc( sizeof( struct event ) );
+
+    if( ev != NULL )
+    {
+        ev->ulTriggered = 0U;
+    }
+
+    return ev;
+}
+
+void event_delete( struct event * ev )
+{
+    free( ev );
+}
+
+bool event_wait( struct event * ev )
+{
+    /* Consume the trigger, sleeping for as long as there is none.  Spurious
+     * wake ups (including EINTR when a signal is handled) loop back round. */
+    while( __atomic_exchange_n( &ev->ulTriggered, 0U, __ATOMIC_ACQUIRE ) == 0U )
+    {
+        prvFutexWait( &ev->ulTriggered, 0U );
+    }
+
+    return true;
+}
+
+void event_signal( struct event * ev )
+{
+    if( __atomic_exchange_n( &ev->ulTriggered, 1U, __ATOMIC_RELEASE ) == 0U )
+    {
+        prvFutexWake( &ev->ulTriggered );
+    }
+}
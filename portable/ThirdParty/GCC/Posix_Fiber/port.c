@@ -0,0 +1,535 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+/* Standard includes. */
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <ucontext.h>
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.hpp"
+
+/*
+ * Every task runs on the one host thread that called xPortStartScheduler().
+ * The stack allocated for each task by the kernel is the stack the task
+ * really executes on, and a context switch saves the callee saved registers
+ * of the task being switched out onto its own stack, then loads the stack
+ * pointer of the task being switched in.  No system call is made, so a switch
+ * costs about as much as a function call and the number of tasks is limited
+ * only by memory.
+ *
+ * On x86-64 the switch is a short assembly routine.  On other architectures,
+ * or if portUSE_UCONTEXT is defined, swapcontext() is used instead, which
+ * also saves and restores the signal mask of the host thread.
+ *
+ * The tick is an ITIMER_REAL interval timer, and its signal handler runs the
+ * tick on the stack of the interrupted task, exactly as a tick interrupt would
+ * on real hardware.  When configUSE_VIRTUAL_TIME is 1 the timer is never
+ * started - the kernel advances the tick count itself whenever only the idle
+ * task can run.  When configUSE_TICKLESS_IDLE is 1 the idle task reprograms
+ * the timer to expire on the tick it expects to wake on, then waits for the
+ * signal with sigsuspend().  As with any port that preempts tasks, a task can be
+ * switched out while inside a host library call that holds a lock (for
+ * example malloc() or printf()), and with every task on one host thread that
+ * lock can never be released if another task then calls the same function.
+ * Calls like that should be made with the scheduler suspended or from within
+ * a critical section.
+ */
+#if defined( __x86_64__ ) && !defined( portUSE_UCONTEXT )
+    #define portUSE_ASM_SWITCH    1
+#else
+    #define portUSE_ASM_SWITCH    0
+#endif
+
+#define portSIG_TICK                  SIGALRM
+#define portNO_CRITICAL_NESTING       ( ( UBaseType_t ) 0 )
+#define portSTACK_ALIGNMENT           ( ( portPOINTER_SIZE_TYPE ) 16 )
+/* Initial values of the SSE control/status register and the x87 control
+ * word, as set up by the host for a new thread. */
+#define portINITIAL_MXCSR             ( 0x1f80U )
+#define portINITIAL_FPU_CONTROL       ( 0x037fU )
+
+typedef struct FIBER
+{
+    #if ( portUSE_ASM_SWITCH == 1 )
+        void * pvStackPointer;
+    #else
+        ucontext_t xContext;
+    #endif
+    TaskFunction_t pxCode;
+    void * pvParams;
+    UBaseType_t uxCriticalNesting;
+} Fiber_t;
+
+#if ( portUSE_ASM_SWITCH == 1 )
+
+/*
+ * Push the callee saved registers and floating point control state onto the
+ * current stack, store the stack pointer to *ppvSaveStackPointer, then pop the
+ * same state from pvNewStackPointer and return on that stack.
+ */
+    extern "C" void prvSwitchStack( void ** ppvSaveStackPointer,
+                                    void * pvNewStackPointer );
+
+    __asm__ (
+        "   .text                               \n"
+        "   .p2align 4                          \n"
+        "   .type prvSwitchStack, @function     \n"
+        "prvSwitchStack:                        \n"
+        "   pushq %rbp                          \n"
+        "   pushq %rbx                          \n"
+        "   pushq %r12                          \n"
+        "   pushq %r13                          \n"
+        "   pushq %r14                          \n"
+        "   pushq %r15                          \n"
+        "   subq $8, %rsp                       \n"
+        "   stmxcsr (%rsp)                      \n"
+        "   fnstcw 4(%rsp)                      \n"
+        "   movq %rsp, (%rdi)                   \n"
+        "   movq %rsi, %rsp                     \n"
+        "   ldmxcsr (%rsp)                      \n"
+        "   fldcw 4(%rsp)                       \n"
+        "   addq $8, %rsp                       \n"
+        "   popq %r15                           \n"
+        "   popq %r14                           \n"
+        "   popq %r13                           \n"
+        "   popq %r12                           \n"
+        "   popq %rbx                           \n"
+        "   popq %rbp                           \n"
+        "   ret                                 \n"
+        "   .size prvSwitchStack, .-prvSwitchStack \n"
+        );
+#endif /* portUSE_ASM_SWITCH */
+
+/*
+ * The function every task starts in.  It enables (simulated) interrupts for
+ * the task before calling the task function.
+ */
+static void prvFiberStart( void );
+
+/*
+ * Handler for portSIG_TICK.  Processes the tick straight away if the running
+ * task is not inside a critical section, otherwise leaves it pending until
+ * the critical section is exited.
+ */
+static void prvTickSignalHandler( int sig );
+
+/*
+ * Runs TaskIncrementTick() once for every tick that is pending, switching to
+ * a different task if any of them requires it.
+ */
+static void prvProcessPendingTicks( void );
+
+/*
+ * Select the next task to run and switch to its stack.
+ */
+static void prvYield( void );
+static void prvSwitchFiber( Fiber_t * pxFiberToSuspend,
+                            Fiber_t * pxFiberToResume );
+static void prvSetupSignals( void );
+static void prvSetTimer( TickType_t xPeriodMicroseconds );
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+    static uint64_t prvTimevalToMicroseconds( const struct timeval * pxTime );
+    static void prvMicrosecondsToTimeval( uint64_t ullMicroseconds,
+                                          struct timeval * pxTime );
+#endif
+
+/* The signals that represent simulated interrupts. */
+static sigset_t xInterruptSignals;
+static BaseType_t xSignalsSetUp = false;
+/* The fiber of the task that is currently running. */
+static Fiber_t * volatile pxRunningFiber = NULL;
+/* The context of xPortStartScheduler(), resumed by vPortEndScheduler(). */
+static Fiber_t xSchedulerFiber;
+/* Ticks that have not been processed yet. */
+static volatile uint32_t ulPendingTicks = 0U;
+/* Used to ensure nothing is processed during the startup sequence. */
+static volatile BaseType_t xPortRunning = false;
+/* The critical nesting count of the running task.  It is saved to and
+ * restored from the Fiber_t of each task on every context switch. */
+static volatile UBaseType_t uxCriticalNesting = portNO_CRITICAL_NESTING;
+
+static Fiber_t * prvGetFiberFromTask( TaskHandle_t xTask )
+{
+    /* The first member of the TCB is the top of stack pointer, which in this
+     * port points to the Fiber_t of the task. */
+    return ( Fiber_t * ) *( ( StackType_t ** ) xTask );
+}
+
+static void prvSetupSignals( void )
+{
+    struct sigaction xSigTick;
+
+    sigemptyset( &xInterruptSignals );
+    sigaddset( &xInterruptSignals, portSIG_TICK );
+
+    /* The tick is not masked while its handler runs, so the handler can
+     * switch to a task that was not itself interrupted by a tick without
+     * leaving the signal blocked.  A tick that arrives while a previous one
+     * is being processed finds the critical nesting count raised and is left
+     * pending. */
+    xSigTick.sa_flags = SA_RESTART | SA_NODEFER;
+    xSigTick.sa_handler = prvTickSignalHandler;
+    sigemptyset( &xSigTick.sa_mask );
+    ( void ) sigaction( portSIG_TICK, &xSigTick, NULL );
+
+    xSignalsSetUp = true;
+}
+
+static void prvSetTimer( TickType_t xPeriodMicroseconds )
+{
+    struct itimerval xTimer;
+
+    xTimer.it_interval.tv_sec = ( time_t ) ( xPeriodMicroseconds / 1000000U );
+    xTimer.it_interval.tv_usec = ( suseconds_t ) ( xPeriodMicroseconds % 1000000U );
+    xTimer.it_value = xTimer.it_interval;
+    ( void ) setitimer( ITIMER_REAL, &xTimer, NULL );
+}
+
+StackType_t * PortInitialiseStack( StackType_t * StackTop,
+                                   StackType_t * StackEnd,
+                                   TaskFunction_t Code,
+                                   void * Params )
+{
+    Fiber_t * pxFiber;
+    portPOINTER_SIZE_TYPE uxStackTop;
+
+    /* The Fiber_t is placed at the top of the stack created for the task, and
+     * the rest of the stack, down to StackEnd, is what the task runs on. */
+    pxFiber = ( Fiber_t * ) ( ( ( int8_t * ) StackTop ) - sizeof( Fiber_t ) );
+    pxFiber = ( Fiber_t * ) ( ( ( portPOINTER_SIZE_TYPE ) pxFiber ) & ~( portSTACK_ALIGNMENT - 1 ) );
+    pxFiber->pxCode = Code;
+    pxFiber->pvParams = Params;
+    pxFiber->uxCriticalNesting = portNO_CRITICAL_NESTING;
+    uxStackTop = ( portPOINTER_SIZE_TYPE ) pxFiber;
+
+    #if ( portUSE_ASM_SWITCH == 1 )
+    {
+        uint64_t * pullStack = ( uint64_t * ) uxStackTop;
+
+        /* Build the frame prvSwitchStack() pops, so the first switch to the
+         * task "returns" into prvFiberStart() with the stack aligned as it
+         * would be on entry to any function. */
+        *( --pullStack ) = 0U;                                      /* Return address of prvFiberStart(). */
+        *( --pullStack ) = ( uint64_t ) ( uintptr_t ) prvFiberStart; /* Return address of prvSwitchStack(). */
+        *( --pullStack ) = 0U;                                      /* rbp. */
+        *( --pullStack ) = 0U;                                      /* rbx. */
+        *( --pullStack ) = 0U;                                      /* r12. */
+        *( --pullStack ) = 0U;                                      /* r13. */
+        *( --pullStack ) = 0U;                                      /* r14. */
+        *( --pullStack ) = 0U;                                      /* r15. */
+        *( --pullStack ) = ( ( uint64_t ) portINITIAL_FPU_CONTROL << 32 ) | portINITIAL_MXCSR;
+        pxFiber->pvStackPointer = pullStack;
+        ( void ) StackEnd;
+    }
+    #else /* portUSE_ASM_SWITCH */
+    {
+        if( getcontext( &pxFiber->xContext ) != 0 )
+        {
+            fprintf( stderr, "PortInitialiseStack: getcontext() failed\n" );
+            abort();
+        }
+
+        pxFiber->xContext.uc_stack.ss_sp = StackEnd;
+        pxFiber->xContext.uc_stack.ss_size = ( size_t ) ( uxStackTop - ( portPOINTER_SIZE_TYPE ) StackEnd );
+        pxFiber->xContext.uc_link = NULL;
+        /* Tasks always start with (simulated) interrupts enabled. */
+        sigdelset( &pxFiber->xContext.uc_sigmask, portSIG_TICK );
+        makecontext( &pxFiber->xContext, prvFiberStart, 0 );
+    }
+    #endif /* portUSE_ASM_SWITCH */
+
+    return ( StackType_t * ) pxFiber;
+}
+
+static void prvFiberStart( void )
+{
+    Fiber_t * pxFiber = pxRunningFiber;
+
+    /* Running for the first time - the critical nesting count was set up by
+     * prvSwitchFiber(), so process any tick that arrived during the switch. */
+    if( ( uxCriticalNesting == portNO_CRITICAL_NESTING ) &&
+        ( __atomic_load_n( &ulPendingTicks, __ATOMIC_RELAXED ) != 0U ) )
+    {
+        prvProcessPendingTicks();
+    }
+
+    pxFiber->pxCode( pxFiber->pvParams );
+
+    /* A function that implements a task must not return, but if it does the
+     * task is deleted rather than returning off the top of its stack. */
+    TaskDelete( NULL );
+
+    for( ; ; )
+    {
+    }
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+    if( xSignalsSetUp == false )
+    {
+        prvSetupSignals();
+    }
+
+    xSchedulerFiber.uxCriticalNesting = uxCriticalNesting;
+    ulPendingTicks = 0U;
+    uxCriticalNesting = portNO_CRITICAL_NESTING;
+
+    /* The scheduler is now running. */
+    xPortRunning = true;
+    #if ( configUSE_VIRTUAL_TIME == 0 )
+        prvSetTimer( portTICK_RATE_MICROSECONDS );
+    #endif
+    vPortEnableInterrupts();
+
+    /* Start the first task.  This returns when vPortEndScheduler() is called
+     * from a task. */
+    prvSwitchFiber( &xSchedulerFiber, prvGetFiberFromTask( CurrentTaskHandle() ) );
+
+    prvSetTimer( 0U );
+    pxRunningFiber = NULL;
+
+    return 0;
+}
+
+void vPortEndScheduler( void )
+{
+    Fiber_t * pxFiber = pxRunningFiber;
+
+    xPortRunning = false;
+    prvSetTimer( 0U );
+
+    /* If called from a task then switch back to the context that called
+     * xPortStartScheduler().  The task is never resumed. */
+    if( pxFiber != NULL )
+    {
+        prvSwitchFiber( pxFiber, &xSchedulerFiber );
+    }
+}
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+    static uint64_t prvTimevalToMicroseconds( const struct timeval * pxTime )
+    {
+        return ( ( uint64_t ) pxTime->tv_sec * 1000000U ) + ( uint64_t ) pxTime->tv_usec;
+    }
+
+    static void prvMicrosecondsToTimeval( uint64_t ullMicroseconds,
+                                          struct timeval * pxTime )
+    {
+        pxTime->tv_sec = ( time_t ) ( ullMicroseconds / 1000000U );
+        pxTime->tv_usec = ( suseconds_t ) ( ullMicroseconds % 1000000U );
+    }
+
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+        struct itimerval xTimer;
+        sigset_t xSavedSignals;
+        uint64_t ullRemaining;
+        const uint64_t ullPeriod = ( uint64_t ) portTICK_RATE_MICROSECONDS;
+        TickType_t xTicksLeft;
+
+        /* The tick signal is blocked, rather than just held pending by the
+         * critical section, so that it cannot arrive between the timer being
+         * reprogrammed and sigsuspend() being entered. */
+        vPortEnterCritical();
+        sigprocmask( SIG_BLOCK, &xInterruptSignals, &xSavedSignals );
+
+        if( ( TaskConfirmSleepModeStatus() != eAbortSleep ) &&
+            ( __atomic_load_n( &ulPendingTicks, __ATOMIC_RELAXED ) == 0U ) )
+        {
+            /* Keep the phase of the tick: the first tick slept through is
+             * the one the timer is already counting down to. */
+            ( void ) getitimer( ITIMER_REAL, &xTimer );
+            ullRemaining = prvTimevalToMicroseconds( &xTimer.it_value );
+            prvMicrosecondsToTimeval( ullRemaining + ( ( uint64_t ) ( xExpectedIdleTime - 1U ) * ullPeriod ), &xTimer.it_value );
+            prvMicrosecondsToTimeval( ullPeriod, &xTimer.it_interval );
+            ( void ) setitimer( ITIMER_REAL, &xTimer, NULL );
+
+            ( void ) sigsuspend( &xSavedSignals );
+
+            if( __atomic_load_n( &ulPendingTicks, __ATOMIC_RELAXED ) != 0U )
+            {
+                /* Slept for the whole time.  The final tick is pending and is
+                 * processed when the critical section is exited. */
+                ( void ) CatchUpTicks( xExpectedIdleTime - 1U );
+            }
+            else
+            {
+                /* Woken early by some other signal.  Work out how many of the
+                 * ticks have passed and put the timer back on its period. */
+                ( void ) getitimer( ITIMER_REAL, &xTimer );
+                ullRemaining = prvTimevalToMicroseconds( &xTimer.it_value );
+                xTicksLeft = ( TickType_t ) ( ( ullRemaining + ullPeriod - 1U ) / ullPeriod );
+
+                if( xTicksLeft > xExpectedIdleTime )
+                {
+                    xTicksLeft = xExpectedIdleTime;
+                }
+
+                if( xTicksLeft > 0U )
+                {
+                    prvMicrosecondsToTimeval( ullRemaining - ( ( uint64_t ) ( xTicksLeft - 1U ) * ullPeriod ), &xTimer.it_value );
+                    ( void ) setitimer( ITIMER_REAL, &xTimer, NULL );
+                }
+
+                ( void ) CatchUpTicks( xExpectedIdleTime - xTicksLeft );
+            }
+        }
+
+        sigprocmask( SIG_SETMASK, &xSavedSignals, NULL );
+        vPortExitCritical();
+    }
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+static void prvTickSignalHandler( int sig )
+{
+    ( void ) sig;
+
+    /* Counted with an atomic add, as the handler can interrupt another
+     * instance of prvProcessPendingTicks() consuming the count. */
+    __atomic_fetch_add( &ulPendingTicks, 1U, __ATOMIC_RELAXED );
+
+    /* Inside a critical section interrupts are (simulated as) disabled, so
+     * the tick stays pending until vPortExitCritical() processes it. */
+    if( uxCriticalNesting == portNO_CRITICAL_NESTING )
+    {
+        prvProcessPendingTicks();
+    }
+}
+
+static void prvProcessPendingTicks( void )
+{
+    uint32_t ulTicks;
+    BaseType_t xSwitchRequired = false;
+
+    if( xPortRunning == false )
+    {
+        return;
+    }
+
+    uxCriticalNesting++;
+
+    for( ulTicks = __atomic_exchange_n( &ulPendingTicks, 0U, __ATOMIC_RELAXED ); ulTicks > 0U; ulTicks-- )
+    {
+        if( TaskIncrementTick() != false )
+        {
+            xSwitchRequired = true;
+        }
+    }
+
+    if( xSwitchRequired != false )
+    {
+        prvYield();
+    }
+
+    uxCriticalNesting--;
+}
+
+static void prvYield( void )
+{
+    Fiber_t * pxFiberToSuspend;
+
+    pxFiberToSuspend = pxRunningFiber;
+    SwitchContext();
+    prvSwitchFiber( pxFiberToSuspend, prvGetFiberFromTask( CurrentTaskHandle() ) );
+}
+
+static void prvSwitchFiber( Fiber_t * pxFiberToSuspend,
+                            Fiber_t * pxFiberToResume )
+{
+    if( pxFiberToSuspend != pxFiberToResume )
+    {
+        /* A task switched out by a yield or tick resumes with the nesting
+         * count it had, which is how a task can yield inside a critical
+         * section.  A task that has not run before starts with none. */
+        pxFiberToSuspend->uxCriticalNesting = uxCriticalNesting;
+        uxCriticalNesting = pxFiberToResume->uxCriticalNesting;
+        pxRunningFiber = pxFiberToResume;
+
+        #if ( portUSE_ASM_SWITCH == 1 )
+            prvSwitchStack( &pxFiberToSuspend->pvStackPointer, pxFiberToResume->pvStackPointer );
+        #else
+            ( void ) swapcontext( &pxFiberToSuspend->xContext, &pxFiberToResume->xContext );
+        #endif
+    }
+}
+
+void vPortYield( void )
+{
+    if( ( xPortRunning == false ) || ( pxRunningFiber == NULL ) )
+    {
+        return;
+    }
+
+    vPortEnterCritical();
+    prvYield();
+    vPortExitCritical();
+}
+
+void vPortDisableInterrupts( void )
+{
+    sigprocmask( SIG_BLOCK, &xInterruptSignals, NULL );
+}
+
+void vPortEnableInterrupts( void )
+{
+    sigprocmask( SIG_UNBLOCK, &xInterruptSignals, NULL );
+}
+
+void vPortEnterCritical( void )
+{
+    /* No system call is needed to (simulate) disabling interrupts - the tick
+     * signal handler checks the nesting count of the task it interrupts. */
+    uxCriticalNesting++;
+    portSOFTWARE_BARRIER();
+}
+
+void vPortExitCritical( void )
+{
+    portSOFTWARE_BARRIER();
+
+    if( uxCriticalNesting > portNO_CRITICAL_NESTING )
+    {
+        uxCriticalNesting--;
+
+        /* Process any tick that was held pending while interrupts were
+         * (simulated as) disabled. */
+        if( ( uxCriticalNesting == portNO_CRITICAL_NESTING ) &&
+            ( __atomic_load_n( &ulPendingTicks, __ATOMIC_RELAXED ) != 0U ) )
+        {
+            prvProcessPendingTicks();
+        }
+    }
+}
@@ -42,10 +42,37 @@ struct QueuePointers_t {
 };
 
 struct SemaphoreData_t {
-  TaskHandle_t MutHolder;
+  MutexLink_t Mutex;
   UBaseType_t RecursiveCallCount;
+#if (configUSE_MUTEX_FAST_PATH == 1)
+  // NULL while the mutex is free, the holder while it is held without the kernel knowing, or queueMUTEX_IN_KERNEL
+  // while nWaiting, Mutex and PendingRX describe it.
+  TaskHandle_t volatile FastOwner;
+#endif
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+  UBaseType_t SpinLimit;
+  UBaseType_t SpinAcquired;
+  UBaseType_t SpinFailed;
+  UBaseType_t Blocked;
+#endif
 };
+
+#if (configUSE_MUTEX_FAST_PATH == 1)
+#define queueMUTEX_IN_KERNEL ((TaskHandle_t)1)
+#endif
+
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+using EventList_t = PriorityList_t<TCB_t>;
+#else
+using EventList_t = List_t<TCB_t>;
+#endif
 struct Queue_t;
+
+struct CondVar_t {
+  struct Queue_t *Mutex;
+  List_t<TCB_t> Waiting;
+  uint8_t StaticAlloc;
+};
 static BaseType_t NotifyQueueSetContainer(const Queue_t *const Queue);
 
 struct Queue_t {
@@ -55,8 +82,8 @@ struct Queue_t {
     QueuePointers_t q;
     SemaphoreData_t sema;
   } u;
-  List_t<TCB_t> PendingTX;
-  List_t<TCB_t> PendingRX;
+  EventList_t PendingTX;
+  EventList_t PendingRX;
   volatile UBaseType_t nWaiting;
   UBaseType_t length;
   UBaseType_t itemSize;
@@ -64,19 +91,59 @@ struct Queue_t {
   volatile int8_t txLock;
   uint8_t StaticAlloc;
   struct Queue_t *set;
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+  // Set while a producer fills the slot at write, or a consumer works on the item after read, in place.
+  uint8_t Writing;
+  uint8_t Reading;
+#endif
 
   bool IsMutex() const { return Head == nullptr; }
 
   void MakeMutex() { Head = nullptr; }
 
-  bool EmptyFromISR() const { return nWaiting == 0; }
+  // Free slots, and items that can be received. A slot handed out in place hides the rest from the other side's
+  // callers until it comes back, which keeps the ring in order.
+  UBaseType_t SpaceFromISR() const {
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+    if (Writing) {
+      return 0U;
+    }
+#endif
+    return length - nWaiting;
+  }
+
+  UBaseType_t ReadyFromISR() const {
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+    if (Reading) {
+      return 0U;
+    }
+#endif
+    return nWaiting;
+  }
+
+  // Writing to the front, or overwriting, moves read, so neither may happen while a receiver has the item after read.
+  bool CanWriteFromISR(QueuePos_t pos) const {
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+    if (Writing || (Reading && (pos != QueuePos_t::Back))) {
+      return false;
+    }
+#endif
+    return (nWaiting < length) || (pos == QueuePos_t::Overwrite);
+  }
+
+  bool CanWrite(QueuePos_t pos) const {
+    CriticalSection s;
+    return CanWriteFromISR(pos);
+  }
+
+  bool EmptyFromISR() const { return ReadyFromISR() == 0; }
 
   bool Empty() const {
     CriticalSection s;
     return EmptyFromISR();
   }
 
-  bool FullFromISR() const { return nWaiting == length; }
+  bool FullFromISR() const { return SpaceFromISR() == 0; }
 
   bool Full() const {
     CriticalSection s;
@@ -133,20 +200,125 @@ struct Queue_t {
     return MutexHolderFromISR();
   }
 
-  TaskHandle_t MutexHolderFromISR() const { return IsMutex() ? u.sema.MutHolder : nullptr; }
+  TaskHandle_t MutexHolderFromISR() const {
+    if (!IsMutex()) {
+      return nullptr;
+    }
+#if (configUSE_MUTEX_FAST_PATH == 1)
+    TaskHandle_t const Owner = __atomic_load_n(&u.sema.FastOwner, __ATOMIC_ACQUIRE);
+    if (Owner != queueMUTEX_IN_KERNEL) {
+      return Owner;
+    }
+#endif
+    return u.sema.Mutex.Holder;
+  }
+
+#if (configUSE_MUTEX_FAST_PATH == 1)
+  // An uncontended take or give is a single compare-and-swap on FastOwner, with no critical section. Both fail once
+  // the kernel has the mutex, and the caller goes the slow way.
+  bool TakeFast() {
+    TaskHandle_t Expected = NULL;
+    TaskHandle_t const Self = CurrentTaskHandle();
+    return (Self != NULL) && __atomic_compare_exchange_n(&u.sema.FastOwner, &Expected, Self, false, __ATOMIC_ACQUIRE,
+                                                         __ATOMIC_RELAXED);
+  }
+
+  bool GiveFast() {
+    TaskHandle_t Expected = CurrentTaskHandle();
+    return (Expected != NULL) && __atomic_compare_exchange_n(&u.sema.FastOwner, &Expected, (TaskHandle_t)NULL, false,
+                                                             __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+  }
+
+  // Called in a critical section before the slow path looks at the mutex. A mutex taken on the fast path is recorded
+  // as held, so that a task can wait for it and the holder can inherit. Holder is set before the swap so that the
+  // holder never reads a NULL holder once FastOwner says the kernel has the mutex.
+  void EnterKernelMutex() {
+    TaskHandle_t Owner = __atomic_load_n(&u.sema.FastOwner, __ATOMIC_ACQUIRE);
+    while (Owner != queueMUTEX_IN_KERNEL) {
+      u.sema.Mutex.Holder = Owner;
+      if (__atomic_compare_exchange_n(&u.sema.FastOwner, &Owner, queueMUTEX_IN_KERNEL, false, __ATOMIC_ACQ_REL,
+                                      __ATOMIC_ACQUIRE)) {
+        if (Owner != NULL) {
+          nWaiting = 0;
+          MutexAdopt(&u.sema.Mutex);
+        }
+        return;
+      }
+    }
+  }
+
+  // Called in a critical section after the slow path gave the mutex back. The fast path takes over again once nobody
+  // waits for the mutex. A ceiling mutex stays with the kernel, which has to raise its holder.
+  void LeaveKernelMutex() {
+    if ((nWaiting != 0) && PendingRX.empty() && (u.sema.Mutex.Ceiling == tskIDLE_PRIORITY)) {
+      __atomic_store_n(&u.sema.FastOwner, (TaskHandle_t)NULL, __ATOMIC_RELEASE);
+    }
+  }
+#endif
+
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+  // Spins while the holder runs on another core, as it may give the mutex back sooner than two context switches would
+  // take. Returns true if the mutex was seen free. The limit moves towards twice the spins that last paid off, and is
+  // halved whenever the holder keeps running through all of it. A mutex found free before any spin tells neither.
+  bool SpinForMutex() {
+    const UBaseType_t Limit = u.sema.SpinLimit;
+    UBaseType_t Spins = 0U;
+    TaskHandle_t Holder = MutexHolderFromISR();
+    while ((Holder != NULL) && (Spins < Limit) && TaskRunningElsewhere(Holder)) {
+      portMEMORY_BARRIER();
+      Spins++;
+      Holder = MutexHolderFromISR();
+    }
+    CriticalSection s;
+    if (Holder == NULL) {
+      if (Spins > 0U) {
+        const UBaseType_t Target = (2U * Spins) + 8U;
+        u.sema.SpinLimit = (Target > Limit) ? Limit + ((Target - Limit) / 8U) : Limit - ((Limit - Target) / 8U);
+        if (u.sema.SpinLimit > (UBaseType_t)configMUTEX_MAX_SPIN) {
+          u.sema.SpinLimit = (UBaseType_t)configMUTEX_MAX_SPIN;
+        }
+        u.sema.SpinAcquired++;
+      }
+      return true;
+    }
+    if (Spins == Limit) {
+      u.sema.SpinLimit = (Limit > 16U) ? Limit / 2U : 8U;
+    }
+    if (Spins > 0U) {
+      u.sema.SpinFailed++;
+    }
+    return false;
+  }
+#endif
 
-  Queue_t *InitAsMutex() {
+  Queue_t *InitAsMutex(UBaseType_t Ceiling) {
     MakeMutex();
-    u.sema.MutHolder = NULL;
+    if (Ceiling >= (UBaseType_t)configMAX_PRIORITIES) {
+      Ceiling = (UBaseType_t)configMAX_PRIORITIES - (UBaseType_t)1U;
+    }
+    u.sema.Mutex.Ceiling = Ceiling;
+    u.sema.Mutex.Holder = NULL;
+    u.sema.Mutex.Waiters = &PendingRX;
+    u.sema.Mutex.HeldItem.init();
+    u.sema.Mutex.HeldItem.Owner = &u.sema.Mutex;
     u.sema.RecursiveCallCount = 0;
+#if (configUSE_MUTEX_FAST_PATH == 1)
+    u.sema.FastOwner = queueMUTEX_IN_KERNEL;
+#endif
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+    u.sema.SpinLimit = (UBaseType_t)configMUTEX_MAX_SPIN;
+    u.sema.SpinAcquired = 0U;
+    u.sema.SpinFailed = 0U;
+    u.sema.Blocked = 0U;
+#endif
     Send(NULL, 0U, QueuePos_t::Back);
     return this;
   }
 
-  Queue_t *InitAsQueue(UBaseType_t length, UBaseType_t itemSIze, uint8_t *storage) {
-    Head = (itemSize > 0 ? (int8_t *)storage : (int8_t *)this);
-    length = length;
-    itemSize = itemSize;
+  Queue_t *InitAsQueue(UBaseType_t len, UBaseType_t size, uint8_t *storage) {
+    Head = (size > 0 ? (int8_t *)storage : (int8_t *)this);
+    length = len;
+    itemSize = size;
     Reset(true);
     set = NULL;
     return this;
@@ -176,11 +348,9 @@ struct Queue_t {
 
   bool copyFrom(void const *buf, QueuePos_t pos) {
     BaseType_t Ret = false;
-    UBaseType_t nWaiting = nWaiting;
     if (itemSize == 0) {
       if (IsMutex()) {
-        Ret = PriorityDisinherit(u.sema.MutHolder);
-        u.sema.MutHolder = NULL;
+        Ret = PriorityDisinherit(&u.sema.Mutex);
       }
     } else if (pos == QueuePos_t::Back) {
       memcpy(write, buf, (size_t)itemSize);
@@ -204,6 +374,72 @@ struct Queue_t {
     return Ret;
   }
 
+  // Writes Count items to the back, which there must be room for, with at most two copies around the end of the ring.
+  void copyFromN(void const *buf, const UBaseType_t Count) {
+    if (itemSize != 0) {
+      const size_t Bytes = (size_t)Count * itemSize;
+      const size_t ToEnd = (size_t)(u.q.pcTail - write);
+      const size_t First = (Bytes < ToEnd) ? Bytes : ToEnd;
+      (void)memcpy(write, buf, First);
+      (void)memcpy(Head, (const int8_t *)buf + First, Bytes - First);
+      write = (Bytes < ToEnd) ? write + Bytes : Head + (Bytes - First);
+    }
+    nWaiting += Count;
+  }
+
+  // Reads Count items from the front, which must be there, with at most two copies around the end of the ring.
+  void copyIntoN(void *buf, const UBaseType_t Count) {
+    if (itemSize != 0) {
+      int8_t *const Start = (u.q.read + itemSize >= u.q.pcTail) ? Head : u.q.read + itemSize;
+      const size_t Bytes = (size_t)Count * itemSize;
+      const size_t ToEnd = (size_t)(u.q.pcTail - Start);
+      const size_t First = (Bytes < ToEnd) ? Bytes : ToEnd;
+      (void)memcpy(buf, Start, First);
+      (void)memcpy((int8_t *)buf + First, Head, Bytes - First);
+      u.q.read = ((Bytes <= ToEnd) ? Start + Bytes : Head + (Bytes - First)) - itemSize;
+    }
+    nWaiting -= Count;
+  }
+
+  // Wakes as many tasks waiting on List as there are items or spaces for them, Count, in one pass. Returns true if one
+  // of them should run before the caller.
+  static bool WakeWaiters(List_t<TCB_t> *const List, UBaseType_t Count) {
+    bool Yield = false;
+    while ((Count-- > 0U) && !List->empty()) {
+      Yield = RemoveFromEventList(List) || Yield;
+    }
+    return Yield;
+  }
+
+  // Tells receivers, or the set the queue is in, about Count items just written.
+  bool NotifyReceivers(UBaseType_t Count) {
+    if (set == NULL) {
+      return WakeWaiters(&PendingRX, Count);
+    }
+    bool Yield = false;
+    while (Count-- > 0U) {
+      Yield = NotifyQueueSetContainer(this) || Yield;
+    }
+    return Yield;
+  }
+
+#if (configUSE_QUEUE_HANDOFF == 1)
+  // Copies an item sent to an empty queue straight into the buffer of the first task waiting to receive it, and wakes
+  // that task with its receive already done. Returns false, changing nothing, when there is no such task.
+  bool HandOff(void const *buf, BaseType_t *const woken) {
+    if ((itemSize == 0U) || (nWaiting != 0U) || (set != NULL) || PendingRX.empty()) {
+      return false;
+    }
+    void *const Buffer = TaskTakeHandoffBuffer(&PendingRX);
+    if (Buffer == NULL) {
+      return false;
+    }
+    (void)memcpy(Buffer, buf, (size_t)itemSize);
+    *woken = RemoveFromEventList(&PendingRX);
+    return true;
+  }
+#endif
+
   bool Reset(bool isQueue) {
     if ((length >= 1U) && ((SIZE_MAX / length) >= itemSize)) {
       CriticalSection s;
@@ -213,6 +449,11 @@ struct Queue_t {
       u.q.read = Head + ((length - 1U) * itemSize);
       rxLock = -1;
       txLock = -1;
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+      // A slot handed out before the reset no longer belongs to the ring, so its commit or release fails.
+      Writing = false;
+      Reading = false;
+#endif
       if (isQueue) {
         PendingTX.init();
         PendingRX.init();
@@ -235,11 +476,30 @@ struct Queue_t {
     bool entryTimeSet = false;
     bool needYield;
     TimeOut_t timeout;
+#if (configUSE_MUTEX_FAST_PATH == 1)
+    if (IsMutex() && GiveFast()) {
+      return true;
+    }
+#endif
     for (;;) {
       {
         CriticalSection s;
-        bool canWriteNow = (nWaiting < length) || (pos == QueuePos_t::Overwrite);
+#if (configUSE_MUTEX_FAST_PATH == 1)
+        if (IsMutex()) {
+          EnterKernelMutex();
+        }
+#endif
+        bool canWriteNow = CanWriteFromISR(pos);
         if (canWriteNow) {
+#if (configUSE_QUEUE_HANDOFF == 1)
+          BaseType_t woken;
+          if (HandOff(item, &woken)) {
+            if (woken) {
+              portYIELD_WITHIN_API();
+            }
+            return true;
+          }
+#endif
           const UBaseType_t nPrevWaiting = nWaiting;
           needYield = copyFrom(item, pos);
           if (set != NULL) {
@@ -258,6 +518,11 @@ struct Queue_t {
             }
             return true;
           }
+#if (configUSE_MUTEX_FAST_PATH == 1)
+          if (IsMutex()) {
+            LeaveKernelMutex();
+          }
+#endif
           if (needYield) {
             portYIELD_WITHIN_API();
           }
@@ -282,7 +547,7 @@ struct Queue_t {
         return false;
       }
 
-      if (Full()) {
+      if (!CanWrite(pos)) {
         PlaceOnEventList(&PendingTX, ticks);
         if (!UnlockAndResume()) {
           taskYIELD_WITHIN_API();
@@ -295,7 +560,14 @@ struct Queue_t {
   }
 };
 static BaseType_t NotifyQueueSetContainer(const Queue_t *const Queue);
-static UBaseType_t GetHighestPriorityOfWaitToReceiveList(Queue_t *const Queue);
+
+static_assert(sizeof(StaticQueue_t) >= sizeof(Queue_t), "StaticQueue_t must be large enough to hold a Queue_t");
+
+BaseType_t Send(Queue_t *q, const void *const item, TickType_t ticks, QueuePos_t pos) {
+  return q->Send(item, ticks, pos);
+}
+
+BaseType_t QueueGenericReset(Queue_t *q, BaseType_t isNew) { return q->Reset(isNew); }
 
 Queue_t *QueueCreateStatic(const UBaseType_t len, const UBaseType_t itemSize, uint8_t *storage,
                            StaticQueue_t *staticQ) {
@@ -332,14 +604,20 @@ Queue_t *QueueCreate(const UBaseType_t len, const UBaseType_t itemSize) {
   return q;
 }
 
-Queue_t *QueueCreateMutex(const uint8_t type) { return QueueCreate(1, 0)->InitAsMutex(); }
+Queue_t *QueueCreateMutex(const uint8_t type) { return QueueCreate(1, 0)->InitAsMutex(tskIDLE_PRIORITY); }
 
 Queue_t *QueueCreateMutexStatic(const uint8_t type, StaticQueue_t *pStaticQueue) {
-  return QueueCreateStatic(1, 0, nullptr, pStaticQueue)->InitAsMutex();
+  return QueueCreateStatic(1, 0, nullptr, pStaticQueue)->InitAsMutex(tskIDLE_PRIORITY);
+}
+
+Queue_t *QueueCreateMutexCeiling(UBaseType_t Ceiling) { return QueueCreate(1, 0)->InitAsMutex(Ceiling); }
+
+Queue_t *QueueCreateMutexCeilingStatic(UBaseType_t Ceiling, StaticQueue_t *pStaticQueue) {
+  return QueueCreateStatic(1, 0, nullptr, pStaticQueue)->InitAsMutex(Ceiling);
 }
 
 BaseType_t QueueGiveMutexRecursive(Queue_t *const Mutex) {
-  if (Mutex->u.sema.MutHolder != CurrentTaskHandle()) {
+  if (Mutex->MutexHolderFromISR() != CurrentTaskHandle()) {
     return false;
   }
   if (--Mutex->u.sema.RecursiveCallCount == 0) {
@@ -349,7 +627,7 @@ BaseType_t QueueGiveMutexRecursive(Queue_t *const Mutex) {
 }
 
 bool QueueTakeMutexRecursive(Queue_t *const mut, TickType_t ticks) {
-  if (mut->u.sema.MutHolder == CurrentTaskHandle()) {
+  if (mut->MutexHolderFromISR() == CurrentTaskHandle()) {
     mut->u.sema.RecursiveCallCount++;
     return true;
   }
@@ -360,6 +638,17 @@ bool QueueTakeMutexRecursive(Queue_t *const mut, TickType_t ticks) {
   }
   return ret;
 }
+
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+void QueueGetMutexSpinStats(Queue_t *const Mutex, MutexSpinStats_t *Stats) {
+  CriticalSection s;
+  Stats->SpinAcquired = Mutex->u.sema.SpinAcquired;
+  Stats->SpinFailed = Mutex->u.sema.SpinFailed;
+  Stats->Blocked = Mutex->u.sema.Blocked;
+  Stats->SpinLimit = Mutex->u.sema.SpinLimit;
+}
+#endif
+
 Queue_t *QueueCreateCountingSemaphoreStatic(const UBaseType_t max, const UBaseType_t init,
                                             StaticQueue_t *pStaticQueue) {
   if ((max == 0U) || (init > max)) {
@@ -387,9 +676,18 @@ BaseType_t SendFromISR(Queue_t *q, const void *const item, BaseType_t *const wok
   portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
   CriticalSectionISR s;
-  if ((q->nWaiting >= q->length) && (pos != QueuePos_t::Overwrite)) {
+  if (!q->CanWriteFromISR(pos)) {
     return false;
   }
+#if (configUSE_QUEUE_HANDOFF == 1)
+  BaseType_t handedOffWoken;
+  if ((q->txLock == -1) && q->HandOff(item, &handedOffWoken)) {
+    if (handedOffWoken && (woken != nullptr)) {
+      *woken = true;
+    }
+    return true;
+  }
+#endif
   const UBaseType_t nPrevWaiting = q->nWaiting;
   q->copyFrom(item, pos);
   if (q->txLock != -1) {
@@ -451,10 +749,22 @@ BaseType_t GiveFromISR(Queue_t *q, BaseType_t *const woken) {
 BaseType_t Recv(Queue_t *q, void *const pvBuffer, TickType_t ticks) {
   BaseType_t entryTimeSet = false;
   TimeOut_t timeout;
+#if (configUSE_QUEUE_HANDOFF == 1)
+  bool offeredBuffer = false;
+#endif
   for (;;) {
     ENTER_CRITICAL();
     {
-      if (q->nWaiting > 0) {
+#if (configUSE_QUEUE_HANDOFF == 1)
+      if (offeredBuffer) {
+        offeredBuffer = false;
+        if (TaskSetHandoffBuffer(NULL) == NULL) {
+          EXIT_CRITICAL();
+          return true;
+        }
+      }
+#endif
+      if (q->ReadyFromISR() > 0) {
         q->copyInto(pvBuffer);
         q->nWaiting--;
         if (q->PendingTX.Length > 0) {
@@ -483,6 +793,12 @@ BaseType_t Recv(Queue_t *q, void *const pvBuffer, TickType_t ticks) {
 
     if (CheckForTimeOut(&timeout, &ticks) == false) {
       if (q->Empty()) {
+#if (configUSE_QUEUE_HANDOFF == 1)
+        if (q->itemSize != 0U) {
+          (void)TaskSetHandoffBuffer(pvBuffer);
+          offeredBuffer = true;
+        }
+#endif
         PlaceOnEventList(&(q->PendingRX), ticks);
         q->Unlock();
         if (ResumeAll() == false) {
@@ -506,14 +822,24 @@ BaseType_t QueueSemaphoreTake(Queue_t *const q, TickType_t ticks) {
   BaseType_t entryTimeSet = false;
   TimeOut_t timeout;
   bool didInherit = false;
+#if (configUSE_MUTEX_FAST_PATH == 1)
+  if (q->IsMutex() && q->TakeFast()) {
+    return true;
+  }
+#endif
   for (;;) {
     {
       CriticalSection s;
+#if (configUSE_MUTEX_FAST_PATH == 1)
+      if (q->IsMutex()) {
+        q->EnterKernelMutex();
+      }
+#endif
       auto n = q->nWaiting;
       if (n > 0) {
         q->nWaiting = n - 1;
         if (q->IsMutex()) {
-          q->u.sema.MutHolder = IncMutexHeldCount();
+          MutexTaken(&q->u.sema.Mutex);
         }
         if (q->PendingTX.Length > 0) {
           if (RemoveFromEventList(&q->PendingTX)) {
@@ -531,6 +857,12 @@ BaseType_t QueueSemaphoreTake(Queue_t *const q, TickType_t ticks) {
       }
     }
 
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+    if (q->IsMutex() && q->SpinForMutex()) {
+      continue;
+    }
+#endif
+
     TaskSuspendAll();
     q->Lock();
 
@@ -538,7 +870,10 @@ BaseType_t QueueSemaphoreTake(Queue_t *const q, TickType_t ticks) {
       if (q->Empty()) {
         if (q->IsMutex()) {
           CriticalSection s;
-          didInherit = PriorityInherit(q->u.sema.MutHolder);
+          didInherit = PriorityInherit(&q->u.sema.Mutex);
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+          q->u.sema.Blocked++;
+#endif
         }
         PlaceOnEventList(&(q->PendingRX), ticks);
         q->Unlock();
@@ -556,7 +891,7 @@ BaseType_t QueueSemaphoreTake(Queue_t *const q, TickType_t ticks) {
       if (q->Empty()) {
         if (didInherit) {
           CriticalSection s;
-          PriorityDisinheritAfterTimeout(q->u.sema.MutHolder, GetHighestPriorityOfWaitToReceiveList(q));
+          PriorityDisinheritAfterTimeout(&q->u.sema.Mutex);
         }
         return errQUEUE_EMPTY;
       }
@@ -570,7 +905,7 @@ BaseType_t QueuePeek(Queue_t *const q, void *const pvBuffer, TickType_t ticks) {
   for (;;) {
     {
       CriticalSection s;
-      const UBaseType_t nWaiting = q->nWaiting;
+      const UBaseType_t nWaiting = q->ReadyFromISR();
       if (nWaiting > 0) {
         int8_t *origReadPos = q->u.q.read;
         q->copyInto(pvBuffer);
@@ -619,7 +954,7 @@ BaseType_t RecvFromISR(Queue_t *q, void *const pvBuffer, BaseType_t *const woken
   UBaseType_t savedIrqStatus;
   portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
   savedIrqStatus = (UBaseType_t)ENTER_CRITICAL_FROM_ISR();
-  const UBaseType_t nWaiting = q->nWaiting;
+  const UBaseType_t nWaiting = q->ReadyFromISR();
   if (nWaiting > 0) {
     const int8_t rxLock = q->rxLock;
     q->copyInto(pvBuffer);
@@ -649,7 +984,7 @@ BaseType_t QueuePeekFromISR(Queue_t *const q, void *const pvBuffer) {
   int8_t *origReadPos;
   portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
   savedIrqStatus = (UBaseType_t)ENTER_CRITICAL_FROM_ISR();
-  if (q->nWaiting > 0) {
+  if (q->ReadyFromISR() > 0) {
     origReadPos = q->u.q.read;
     q->copyInto(pvBuffer);
     q->u.q.read = origReadPos;
@@ -661,8 +996,279 @@ BaseType_t QueuePeekFromISR(Queue_t *const q, void *const pvBuffer) {
   return Ret;
 }
 
+UBaseType_t SendN(Queue_t *q, const void *const items, const UBaseType_t n, TickType_t ticks) {
+  bool entryTimeSet = false;
+  TimeOut_t timeout;
+  if (q->IsMutex() || (n == 0U)) {
+    return 0U;
+  }
+  for (;;) {
+    {
+      CriticalSection s;
+      const UBaseType_t Space = q->SpaceFromISR();
+      if (Space > 0U) {
+        const UBaseType_t Count = (n < Space) ? n : Space;
+        q->copyFromN(items, Count);
+        if (q->NotifyReceivers(Count)) {
+          portYIELD_WITHIN_API();
+        }
+        return Count;
+      }
+      if (ticks == 0) {
+        return 0U;
+      }
+      if (!entryTimeSet) {
+        SetTimeOutState(&timeout);
+        entryTimeSet = true;
+      }
+    }
+
+    TaskSuspendAll();
+    q->Lock();
+
+    if (CheckForTimeOut(&timeout, &ticks)) {
+      q->UnlockAndResume();
+      return 0U;
+    }
+
+    if (q->Full()) {
+      PlaceOnEventList(&q->PendingTX, ticks);
+      if (!q->UnlockAndResume()) {
+        taskYIELD_WITHIN_API();
+      }
+      continue;
+    }
+
+    q->UnlockAndResume();
+  }
+}
+
+UBaseType_t RecvN(Queue_t *q, void *const buf, const UBaseType_t n, TickType_t ticks) {
+  bool entryTimeSet = false;
+  TimeOut_t timeout;
+  if (q->IsMutex() || (n == 0U)) {
+    return 0U;
+  }
+  for (;;) {
+    {
+      CriticalSection s;
+      const UBaseType_t Ready = q->ReadyFromISR();
+      if (Ready > 0U) {
+        const UBaseType_t Count = (n < Ready) ? n : Ready;
+        q->copyIntoN(buf, Count);
+        if (Queue_t::WakeWaiters(&q->PendingTX, Count)) {
+          portYIELD_WITHIN_API();
+        }
+        return Count;
+      }
+      if (ticks == 0) {
+        return 0U;
+      }
+      if (!entryTimeSet) {
+        SetTimeOutState(&timeout);
+        entryTimeSet = true;
+      }
+    }
+
+    TaskSuspendAll();
+    q->Lock();
+
+    if (CheckForTimeOut(&timeout, &ticks)) {
+      q->UnlockAndResume();
+      return 0U;
+    }
+
+    if (q->Empty()) {
+      PlaceOnEventList(&q->PendingRX, ticks);
+      if (!q->UnlockAndResume()) {
+        taskYIELD_WITHIN_API();
+      }
+      continue;
+    }
+
+    q->UnlockAndResume();
+  }
+}
+
+UBaseType_t SendNFromISR(Queue_t *q, const void *const items, const UBaseType_t n, BaseType_t *const woken) {
+  portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+  CriticalSectionISR s;
+  const UBaseType_t Space = q->SpaceFromISR();
+  const UBaseType_t Count = (n < Space) ? n : Space;
+  if (q->IsMutex() || (Count == 0U)) {
+    return 0U;
+  }
+  q->copyFromN(items, Count);
+  if (q->txLock != -1) {
+    for (UBaseType_t i = 0U; i < Count; i++) {
+      q->incTXLock();
+    }
+  } else if (q->NotifyReceivers(Count) && (woken != nullptr)) {
+    *woken = true;
+  }
+  return Count;
+}
+
+UBaseType_t RecvNFromISR(Queue_t *q, void *const buf, const UBaseType_t n, BaseType_t *const woken) {
+  portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+  CriticalSectionISR s;
+  const UBaseType_t Ready = q->ReadyFromISR();
+  const UBaseType_t Count = (n < Ready) ? n : Ready;
+  if (q->IsMutex() || (Count == 0U)) {
+    return 0U;
+  }
+  q->copyIntoN(buf, Count);
+  if (q->rxLock != -1) {
+    for (UBaseType_t i = 0U; i < Count; i++) {
+      q->incRXLock();
+    }
+  } else if (Queue_t::WakeWaiters(&q->PendingTX, Count) && (woken != nullptr)) {
+    *woken = true;
+  }
+  return Count;
+}
+
+#if (configUSE_QUEUE_ZERO_COPY == 1)
+void *QueueReserve(Queue_t *q, TickType_t ticks) {
+  bool entryTimeSet = false;
+  TimeOut_t timeout;
+  if (q->itemSize == 0U) {
+    return nullptr;
+  }
+  for (;;) {
+    {
+      CriticalSection s;
+      if (!q->FullFromISR()) {
+        q->Writing = true;
+        return q->write;
+      }
+      if (ticks == 0) {
+        return nullptr;
+      }
+      if (!entryTimeSet) {
+        SetTimeOutState(&timeout);
+        entryTimeSet = true;
+      }
+    }
+
+    TaskSuspendAll();
+    q->Lock();
+
+    if (CheckForTimeOut(&timeout, &ticks)) {
+      q->UnlockAndResume();
+      return nullptr;
+    }
+
+    if (q->Full()) {
+      PlaceOnEventList(&q->PendingTX, ticks);
+      if (!q->UnlockAndResume()) {
+        taskYIELD_WITHIN_API();
+      }
+      continue;
+    }
+
+    q->UnlockAndResume();
+  }
+}
+
+BaseType_t QueueCommit(Queue_t *q) {
+  CriticalSection s;
+  if (!q->Writing) {
+    return false;
+  }
+  q->Writing = false;
+  q->write += q->itemSize;
+  if (q->write >= q->u.q.pcTail) {
+    q->write = q->Head;
+  }
+  q->nWaiting++;
+  bool Yield = q->NotifyReceivers(1U);
+  // Producers that found the queue full while the slot was out may fit now.
+  if (!q->FullFromISR()) {
+    Yield = Queue_t::WakeWaiters(&q->PendingTX, 1U) || Yield;
+  }
+  if (Yield) {
+    portYIELD_WITHIN_API();
+  }
+  return true;
+}
+
+void *QueueAcquire(Queue_t *q, TickType_t ticks) {
+  bool entryTimeSet = false;
+  TimeOut_t timeout;
+  if (q->itemSize == 0U) {
+    return nullptr;
+  }
+  for (;;) {
+    {
+      CriticalSection s;
+      if (!q->EmptyFromISR()) {
+        q->Reading = true;
+        return (q->u.q.read + q->itemSize >= q->u.q.pcTail) ? q->Head : q->u.q.read + q->itemSize;
+      }
+      if (ticks == 0) {
+        return nullptr;
+      }
+      if (!entryTimeSet) {
+        SetTimeOutState(&timeout);
+        entryTimeSet = true;
+      }
+    }
+
+    TaskSuspendAll();
+    q->Lock();
+
+    if (CheckForTimeOut(&timeout, &ticks)) {
+      q->UnlockAndResume();
+      return nullptr;
+    }
+
+    if (q->Empty()) {
+      PlaceOnEventList(&q->PendingRX, ticks);
+      if (!q->UnlockAndResume()) {
+        taskYIELD_WITHIN_API();
+      }
+      continue;
+    }
+
+    q->UnlockAndResume();
+  }
+}
+
+BaseType_t QueueRelease(Queue_t *q) {
+  CriticalSection s;
+  if (!q->Reading) {
+    return false;
+  }
+  q->Reading = false;
+  q->u.q.read += q->itemSize;
+  if (q->u.q.read >= q->u.q.pcTail) {
+    q->u.q.read = q->Head;
+  }
+  q->nWaiting--;
+  // Senders to the front wait for the release even while there is space, so every free slot may have one.
+  bool Yield = Queue_t::WakeWaiters(&q->PendingTX, q->SpaceFromISR());
+  // Consumers that found the queue empty while the item was out may have one now.
+  if (!q->EmptyFromISR()) {
+    Yield = Queue_t::WakeWaiters(&q->PendingRX, 1U) || Yield;
+  }
+  if (Yield) {
+    portYIELD_WITHIN_API();
+  }
+  return true;
+}
+#endif
+
 UBaseType_t uxQueueMessagesWaiting(const Queue_t *q) {
   CriticalSection s;
+#if (configUSE_MUTEX_FAST_PATH == 1)
+  // A mutex held on the fast path still counts as free in nWaiting.
+  if (q->IsMutex() && (q->MutexHolderFromISR() != NULL)) {
+    return 0U;
+  }
+#endif
   return ((Queue_t *)q)->nWaiting;
 }
 
@@ -679,20 +1285,87 @@ void vQueueDelete(Queue_t *q) {
   }
 }
 
-static UBaseType_t GetHighestPriorityOfWaitToReceiveList(Queue_t *const Queue) {
-  if (Queue->PendingRX.Length > 0U) {
-    return configMAX_PRIORITIES - (Queue->PendingRX.head()->Value);
-  }
-  return tskIDLE_PRIORITY;
-}
-
 void vQueueWaitForMessageRestricted(Queue_t *Queue, TickType_t ticks, const BaseType_t xWaitIndefinitely) {
   Queue->Lock();
-  if (Queue->nWaiting == 0U) {
+  if (Queue->EmptyFromISR()) {
     PlaceOnEventListRestricted(&(Queue->PendingRX), ticks, xWaitIndefinitely);
   }
   Queue->Unlock();
 }
+static_assert(sizeof(StaticCondVar_t) >= sizeof(CondVar_t), "StaticCondVar_t must be large enough to hold a CondVar_t");
+
+CondVar_t *CondVarCreate(Queue_t *Mutex) {
+  CondVar_t *Cond = (CondVar_t *)pvPortMalloc(sizeof(CondVar_t));
+  if (Cond != nullptr) {
+    Cond->Mutex = Mutex;
+    Cond->Waiting.init();
+    Cond->StaticAlloc = false;
+  }
+  return Cond;
+}
+
+CondVar_t *CondVarCreateStatic(Queue_t *Mutex, StaticCondVar_t *pStaticCondVar) {
+  CondVar_t *Cond = (CondVar_t *)pStaticCondVar;
+  if (Cond != nullptr) {
+    Cond->Mutex = Mutex;
+    Cond->Waiting.init();
+    Cond->StaticAlloc = true;
+  }
+  return Cond;
+}
+
+// The mutex is given and the task placed on the wait list with the scheduler suspended, so that no notification can
+// fall between the two.
+BaseType_t CondVarWait(CondVar_t *Cond, TickType_t ticks) {
+  if (ticks == 0) {
+    return false;
+  }
+  TaskSuspendAll();
+  (void)TaskTakeSignal();
+  (void)Cond->Mutex->Send(NULL, 0, QueuePos_t::Back);
+  PlaceOnEventList(&Cond->Waiting, ticks);
+  if (ResumeAll() == false) {
+    taskYIELD_WITHIN_API();
+  }
+  (void)QueueSemaphoreTake(Cond->Mutex, portMAX_DELAY);
+  CriticalSection s;
+  return TaskTakeSignal();
+}
+
+// Called in a critical section. A waiter only waits for the mutex if someone holds it to give it back, otherwise it is
+// woken to take the mutex itself.
+static void CondVarNotifyOne(CondVar_t *Cond) {
+  Queue_t *const Mutex = Cond->Mutex;
+#if (configUSE_MUTEX_FAST_PATH == 1)
+  Mutex->EnterKernelMutex();
+#endif
+  if (Mutex->nWaiting == 0) {
+    RequeueOnMutex(&Cond->Waiting, &Mutex->u.sema.Mutex);
+  } else if (SignalFromEventList(&Cond->Waiting)) {
+    portYIELD_WITHIN_API();
+  }
+}
+
+void CondVarNotify(CondVar_t *Cond) {
+  CriticalSection s;
+  if (!Cond->Waiting.empty()) {
+    CondVarNotifyOne(Cond);
+  }
+}
+
+void CondVarNotifyAll(CondVar_t *Cond) {
+  CriticalSection s;
+  while (!Cond->Waiting.empty()) {
+    CondVarNotifyOne(Cond);
+  }
+}
+
+void CondVarDelete(CondVar_t *Cond) {
+  if (!Cond->StaticAlloc) {
+    vPortFree(Cond);
+  }
+}
+
 QueueSetHandle_t QueueCreateSet(const UBaseType_t uxEventQueueLength) {
   return QueueCreate(uxEventQueueLength, (UBaseType_t)sizeof(Queue_t *));
 }
@@ -743,3 +1416,124 @@ static BaseType_t NotifyQueueSetContainer(const Queue_t *const q) {
   }
   return ret;
 }
+
+#if (configUSE_SPSC_QUEUES == 1)
+// A ring of Slots items, one always left empty, for exactly one producer and one consumer. Tail is written only by the
+// producer and Head and Consumer only by the consumer, each aligned to its own cache line so that neither side's
+// writes take the other's line away. The struct is placed on a line boundary inside Block, and Storage follows it.
+struct SPSCQueue_t {
+  alignas(portCACHE_LINE_SIZE) volatile UBaseType_t Tail;
+  alignas(portCACHE_LINE_SIZE) volatile UBaseType_t Head;
+  TaskHandle_t volatile Consumer;
+  alignas(portCACHE_LINE_SIZE) UBaseType_t Slots;
+  UBaseType_t itemSize;
+  UBaseType_t NotifyIndex;
+  uint8_t *Storage;
+  void *Block;
+
+  UBaseType_t next(const UBaseType_t Slot) const { return (Slot + 1U == Slots) ? 0U : Slot + 1U; }
+
+  // Returns the slot the item went into, or Slots if the ring was full.
+  UBaseType_t push(const void *const item) {
+    const UBaseType_t T = Tail;
+    const UBaseType_t Next = next(T);
+    if (Next == __atomic_load_n(&Head, __ATOMIC_ACQUIRE)) {
+      return Slots;
+    }
+    (void)memcpy(&Storage[T * itemSize], item, (size_t)itemSize);
+    __atomic_store_n(&Tail, Next, __ATOMIC_RELEASE);
+    return T;
+  }
+
+  bool pop(void *const buf) {
+    const UBaseType_t H = Head;
+    if (H == __atomic_load_n(&Tail, __ATOMIC_ACQUIRE)) {
+      return false;
+    }
+    (void)memcpy(buf, &Storage[H * itemSize], (size_t)itemSize);
+    __atomic_store_n(&Head, next(H), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  // The consumer to notify after an item went into Slot, or NULL. Only an item that finds the consumer caught up with
+  // it, so that the ring was empty, needs to wake it. The fence pairs with the one the consumer passes before it goes
+  // to sleep: either the consumer sees the new tail, or the producer sees the consumer's head at Slot.
+  TaskHandle_t consumerToWake(const UBaseType_t Slot) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&Head, __ATOMIC_RELAXED) != Slot) {
+      return NULL;
+    }
+    return __atomic_load_n(&Consumer, __ATOMIC_ACQUIRE);
+  }
+};
+
+SPSCQueue_t *QueueCreateSPSC(const UBaseType_t len, const UBaseType_t itemSize) {
+  const size_t Header = sizeof(SPSCQueue_t) + portCACHE_LINE_SIZE - 1U;
+  if ((len == 0U) || (itemSize == 0U) || (((SIZE_MAX - Header) / itemSize) < ((size_t)len + 1U))) {
+    return nullptr;
+  }
+  void *const Block = pvPortMalloc(Header + ((size_t)len + 1U) * itemSize);
+  if (Block == nullptr) {
+    return nullptr;
+  }
+  SPSCQueue_t *const q =
+      (SPSCQueue_t *)(((uintptr_t)Block + portCACHE_LINE_SIZE - 1U) & ~(uintptr_t)(portCACHE_LINE_SIZE - 1U));
+  q->Block = Block;
+  q->Tail = 0U;
+  q->Head = 0U;
+  q->Consumer = NULL;
+  q->Slots = len + 1U;
+  q->itemSize = itemSize;
+  q->NotifyIndex = tskDEFAULT_INDEX_TO_NOTIFY;
+  q->Storage = (uint8_t *)q + sizeof(SPSCQueue_t);
+  return q;
+}
+
+BaseType_t QueueSendSPSC(SPSCQueue_t *q, const void *const item) {
+  const UBaseType_t Slot = q->push(item);
+  if (Slot == q->Slots) {
+    return false;
+  }
+  TaskHandle_t const Consumer = q->consumerToWake(Slot);
+  if (Consumer != NULL) {
+    (void)TaskNotifyIndexed(Consumer, q->NotifyIndex, (uint32_t)0, eNoAction);
+  }
+  return true;
+}
+
+BaseType_t QueueSendSPSCFromISR(SPSCQueue_t *q, const void *const item, BaseType_t *const woken) {
+  const UBaseType_t Slot = q->push(item);
+  if (Slot == q->Slots) {
+    return false;
+  }
+  TaskHandle_t const Consumer = q->consumerToWake(Slot);
+  if (Consumer != NULL) {
+    (void)TaskNotifyIndexedFromISR(Consumer, q->NotifyIndex, (uint32_t)0, eNoAction, woken);
+  }
+  return true;
+}
+
+BaseType_t QueueRecvSPSC(SPSCQueue_t *q, void *const buf, TickType_t ticks) {
+  if (q->pop(buf)) {
+    return true;
+  }
+  if (ticks == 0) {
+    return false;
+  }
+  // A notification left over from an item already taken only costs another look at the ring, so none is cleared
+  // here, where clearing could lose one sent after the look.
+  __atomic_store_n(&q->Consumer, CurrentTaskHandle(), __ATOMIC_RELEASE);
+  TimeOut_t timeout;
+  TaskSetTimeOutState(&timeout);
+  do {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (q->pop(buf)) {
+      return true;
+    }
+    (void)TaskNotifyWaitIndexed(q->NotifyIndex, (uint32_t)0, (uint32_t)0, NULL, ticks);
+  } while (CheckForTimeOut(&timeout, &ticks) == false);
+  return q->pop(buf);
+}
+
+void QueueDeleteSPSC(SPSCQueue_t *q) { vPortFree(q->Block); }
+#endif
@@ -0,0 +1,222 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#include "rwlock.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.hpp"
+
+struct RWLock_t {
+  // Tasks holding the lock for reading.
+  UBaseType_t Readers;
+  // Writers waiting for the lock, counting those woken that have yet to take it. New readers wait while there are any.
+  UBaseType_t WritersPending;
+  // A writer holds both links, so that it inherits from waiting writers and waiting readers alike.
+  MutexLink_t WriterLink;
+  MutexLink_t ReaderLink;
+  List_t<TCB_t> WaitingWriters;
+  List_t<TCB_t> WaitingReaders;
+  uint8_t Writing;
+  uint8_t StaticallyAllocated;
+
+  RWLock_t *Init() {
+    Readers = 0U;
+    WritersPending = 0U;
+    Writing = false;
+    WaitingWriters.init();
+    WaitingReaders.init();
+    InitLink(&WriterLink, &WaitingWriters);
+    InitLink(&ReaderLink, &WaitingReaders);
+    return this;
+  }
+
+  static void InitLink(MutexLink_t *Link, List_t<TCB_t> *Waiters) {
+    Link->Holder = NULL;
+    Link->Waiters = Waiters;
+    Link->HeldItem.init();
+    Link->HeldItem.Owner = Link;
+    Link->Ceiling = tskIDLE_PRIORITY;
+  }
+
+  bool CanRead() const { return !Writing && (WritersPending == 0U); }
+
+  bool CanWrite() const { return !Writing && (Readers == 0U); }
+
+  // Called in a critical section whenever the lock may have become free. The first waiting writer is woken if it can
+  // take the lock, otherwise every waiting reader is, in a single pass over the list with at most one yield.
+  void Release() {
+    bool Yield = false;
+    if (!WaitingWriters.empty()) {
+      if (CanWrite()) {
+        Yield = RemoveFromEventList(&WaitingWriters);
+      }
+    } else if (CanRead()) {
+      while (!WaitingReaders.empty()) {
+        if (RemoveFromEventList(&WaitingReaders)) {
+          Yield = true;
+        }
+      }
+    }
+    if (Yield) {
+      portYIELD_WITHIN_API();
+    }
+  }
+
+  BaseType_t Take(const bool Write, TickType_t ticks) {
+    List_t<TCB_t> *const Waiters = Write ? &WaitingWriters : &WaitingReaders;
+    MutexLink_t *const Link = Write ? &WriterLink : &ReaderLink;
+    bool entryTimeSet = false;
+    bool pending = false;
+    bool didInherit = false;
+    TimeOut_t timeout;
+    for (;;) {
+      {
+        CriticalSection s;
+        if (Write ? CanWrite() : CanRead()) {
+          if (Write) {
+            Writing = true;
+            if (pending) {
+              WritersPending--;
+            }
+            MutexTaken(&WriterLink);
+            MutexTaken(&ReaderLink);
+          } else {
+            Readers++;
+          }
+          return true;
+        }
+        if (ticks == 0) {
+          return false;
+        }
+        if (!entryTimeSet) {
+          SetTimeOutState(&timeout);
+          entryTimeSet = true;
+        }
+        if (Write && !pending) {
+          WritersPending++;
+          pending = true;
+        }
+      }
+
+      TaskSuspendAll();
+
+      if (!CheckForTimeOut(&timeout, &ticks)) {
+        bool block;
+        {
+          CriticalSection s;
+          block = !(Write ? CanWrite() : CanRead());
+          if (block && PriorityInherit(Link)) {
+            didInherit = true;
+          }
+        }
+        if (block) {
+          PlaceOnEventList(Waiters, ticks);
+          if (ResumeAll() == false) {
+            taskYIELD_WITHIN_API();
+          }
+        } else {
+          (void)ResumeAll();
+        }
+      } else {
+        (void)ResumeAll();
+
+        CriticalSection s;
+        if (!(Write ? CanWrite() : CanRead())) {
+          if (didInherit) {
+            PriorityDisinheritAfterTimeout(Link);
+          }
+          if (pending) {
+            // Readers kept out by this writer may go now.
+            WritersPending--;
+            Release();
+          }
+          return false;
+        }
+      }
+    }
+  }
+};
+
+static_assert(sizeof(StaticRWLock_t) >= sizeof(RWLock_t), "StaticRWLock_t must be large enough to hold a RWLock_t");
+
+RWLock_t *RWLockCreate(void) {
+  RWLock_t *Lock = (RWLock_t *)pvPortMalloc(sizeof(RWLock_t));
+  if (Lock == nullptr) {
+    return Lock;
+  }
+  Lock->StaticallyAllocated = false;
+  return Lock->Init();
+}
+
+RWLock_t *RWLockCreateStatic(StaticRWLock_t *pStaticRWLock) {
+  if (pStaticRWLock == NULL) {
+    return nullptr;
+  }
+  RWLock_t *Lock = (RWLock_t *)pStaticRWLock;
+  Lock->StaticallyAllocated = true;
+  return Lock->Init();
+}
+
+BaseType_t RWLockReadTake(RWLock_t *Lock, TickType_t ticks) { return Lock->Take(false, ticks); }
+
+BaseType_t RWLockReadGive(RWLock_t *Lock) {
+  CriticalSection s;
+  if (Lock->Readers == 0U) {
+    return false;
+  }
+  if (--Lock->Readers == 0U) {
+    Lock->Release();
+  }
+  return true;
+}
+
+BaseType_t RWLockWriteTake(RWLock_t *Lock, TickType_t ticks) { return Lock->Take(true, ticks); }
+
+BaseType_t RWLockWriteGive(RWLock_t *Lock) {
+  CriticalSection s;
+  if (!Lock->Writing || (Lock->WriterLink.Holder != CurrentTaskHandle())) {
+    return false;
+  }
+  Lock->Writing = false;
+  const BaseType_t Disinherited = PriorityDisinherit(&Lock->ReaderLink);
+  if (PriorityDisinherit(&Lock->WriterLink) || Disinherited) {
+    portYIELD_WITHIN_API();
+  }
+  Lock->Release();
+  return true;
+}
+
+void RWLockDelete(RWLock_t *Lock) {
+  if (!Lock->StaticallyAllocated) {
+    vPortFree(Lock);
+  }
+}
@@ -34,10 +34,13 @@
 #include "FreeRTOS.h"
 #include "task.hpp"
 #include "timers.h"
+#if (configUSE_DELAYED_TASK_WHEEL == 1)
+#include "timing_wheel.hpp"
+#endif
 
 #define taskYIELD_ANY_CORE_IF_USING_PREEMPTION(TCB) \
   do {                                              \
-    if (CurrentTCB->Priority < (TCB)->Priority) {   \
+    if (YieldForTask(TCB)) {                        \
       portYIELD_WITHIN_API();                       \
     }                                               \
   } while (0)
@@ -58,19 +61,40 @@
 #define configIDLE_TASK_NAME "IDLE"
 #endif
 
-#define RECORD_READY_PRIORITY(Priority) portRECORD_READY_PRIORITY((Priority), TopReadyPriority)
+#if (configNUMBER_OF_CORES == 1)
+#define taskREADY_LIST(TCB, Priority) ReadyTasks[(Priority)]
+#define taskTOP_READY_PRIORITY(TCB) TopReadyPriority
+#else
+#define taskREADY_LIST(TCB, Priority) ReadyTasks[(TCB)->ReadyCore][(Priority)]
+#define taskTOP_READY_PRIORITY(TCB) TopReadyPriorities[(TCB)->ReadyCore]
+#endif
+
+#define RECORD_READY_PRIORITY(TCB) taskTOP_READY_PRIORITY(TCB).record((TCB)->Priority)
+
+#define taskRESET_READY_PRIORITY(TCB, Priority)                       \
+  do {                                                                \
+    if (taskREADY_LIST((TCB), (Priority)).Length == (UBaseType_t)0) { \
+      taskTOP_READY_PRIORITY((TCB)).reset(Priority);                  \
+    }                                                                 \
+  } while (0)
 
-#define taskRESET_READY_PRIORITY(Priority)                      \
-  do {                                                          \
-    if (ReadyTasks[(Priority)].Length == (UBaseType_t)0) {      \
-      portRESET_READY_PRIORITY((Priority), (TopReadyPriority)); \
-    }                                                           \
+#if (configUSE_EDF_SCHEDULING == 1)
+#define taskIS_EDF_TASK(TCB) (((TCB)->RelativeDeadline != 0U) && ((TCB)->Priority == (UBaseType_t)configEDF_PRIORITY))
+#define taskEDF_READY(TCB)      \
+  do {                          \
+    if (taskIS_EDF_TASK(TCB)) { \
+      EDFReady.update(TCB);     \
+    }                           \
   } while (0)
+#else
+#define taskEDF_READY(TCB)
+#endif
 
-#define AddTaskToReadyList(TCB)                              \
-  do {                                                       \
-    RECORD_READY_PRIORITY((TCB)->Priority);                  \
-    ReadyTasks[TCB->Priority].append(&(TCB)->StateListItem); \
+#define AddTaskToReadyList(TCB)                                           \
+  do {                                                                    \
+    RECORD_READY_PRIORITY(TCB);                                           \
+    taskREADY_LIST((TCB), (TCB)->Priority).append(&(TCB)->StateListItem); \
+    taskEDF_READY(TCB);                                                   \
   } while (0)
 
 #define GetTCBFromHandle(Handle) (((Handle) == NULL) ? CurrentTCB : (Handle))
@@ -87,20 +111,125 @@
 
 #define taskTASK_SCHEDULED_TO_YIELD ((BaseType_t)(-2))
 
+#if (configNUMBER_OF_CORES == 1)
 #define taskTASK_IS_RUNNING(TCB) (((TCB) == CurrentTCB) ? (true) : (false))
 #define taskTASK_IS_RUNNING_OR_SCHEDULED_TO_YIELD(TCB) (((TCB) == CurrentTCB) ? (true) : (false))
+#else
+#define taskTASK_IS_RUNNING(TCB) (((TCB)->TaskRunState >= (BaseType_t)0) ? (true) : (false))
+#define taskTASK_IS_RUNNING_OR_SCHEDULED_TO_YIELD(TCB) (((TCB)->TaskRunState != taskTASK_NOT_RUNNING) ? (true) : (false))
+#endif
 
 #define taskATTRIBUTE_IS_IDLE (UBaseType_t)(1U << 0U)
 #define taskBITS_PER_BYTE ((size_t)8)
 
+// Ready priorities are kept one bit per priority in words of UBaseType_t, with a summary word holding one bit per
+// non-empty word, so finding the highest ready priority takes two port bit scans however many priorities there are.
+struct ReadyBitmap_t {
+  static constexpr UBaseType_t WordBits = sizeof(UBaseType_t) * taskBITS_PER_BYTE;
+  static constexpr UBaseType_t Words = (configMAX_PRIORITIES + WordBits - 1U) / WordBits;
+  static_assert(Words <= WordBits, "configMAX_PRIORITIES is too large for a two-level ready priority bitmap");
+
+  UBaseType_t Summary;
+  UBaseType_t Word[Words];
+
+  void init() {
+    Summary = 0U;
+    for (UBaseType_t word = 0U; word < Words; word++) {
+      Word[word] = 0U;
+    }
+  }
+
+  bool empty() const { return Summary == 0U; }
+
+  void record(const UBaseType_t Priority) {
+    portRECORD_READY_PRIORITY(Priority % WordBits, Word[Priority / WordBits]);
+    portRECORD_READY_PRIORITY(Priority / WordBits, Summary);
+  }
+
+  void reset(const UBaseType_t Priority) {
+    portRESET_READY_PRIORITY(Priority % WordBits, Word[Priority / WordBits]);
+    if (Word[Priority / WordBits] == 0U) {
+      portRESET_READY_PRIORITY(Priority / WordBits, Summary);
+    }
+  }
+
+  // Must not be called when empty.
+  UBaseType_t highest() const {
+    UBaseType_t word = 0U;
+    UBaseType_t bit;
+    if (Words > 1U) {
+      portGET_HIGHEST_PRIORITY(word, Summary);
+    }
+    portGET_HIGHEST_PRIORITY(bit, Word[word]);
+    return word * WordBits + bit;
+  }
+
+  void merge(const ReadyBitmap_t &Other) {
+    Summary |= Other.Summary;
+    for (UBaseType_t word = 0U; word < Words; word++) {
+      Word[word] |= Other.Word[word];
+    }
+  }
+};
+
 struct TCB_t;
+
+// Compares tick times relative to each other, so that times less than half the tick range apart keep their order
+// across a tick count overflow.
+static inline bool TickBefore(const TickType_t A, const TickType_t B) {
+  return (TickType_t)(A - B) > (portMAX_DELAY >> 1);
+}
+
+#if (configUSE_EDF_SCHEDULING == 1)
+#define taskEDF_NOT_QUEUED ((UBaseType_t)-1)
+
+// Binary min-heap of EDF tasks ordered by absolute deadline, each task knowing its own slot. A task that leaves the
+// ready list keeps its slot until it reaches the top, and is moved within the heap rather than added again if it
+// becomes ready before then, so blocking costs nothing and the heap never holds more than the EDF tasks.
+struct DeadlineHeap_t {
+  TCB_t *Tasks[configEDF_MAX_TASKS];
+  UBaseType_t Count;
+
+  void init() { Count = 0U; }
+
+  // Adds TCB, or restores the heap order around it after its deadline changed.
+  void update(TCB_t *TCB);
+
+  void remove(TCB_t *TCB);
+
+  // The ready EDF task with the earliest deadline, or NULL.
+  TCB_t *earliest();
+
+ private:
+  void place(TCB_t *TCB, UBaseType_t Slot);
+  void siftUp(UBaseType_t Slot);
+  void siftDown(UBaseType_t Slot);
+};
+#endif
+
+#if (configNUMBER_OF_CORES == 1)
 TCB_t *volatile CurrentTCB = nullptr;
+#else
+// Each core runs its own task, and code always refers to the one on the core it is executing on.
+TCB_t *volatile CurrentTCBs[configNUMBER_OF_CORES] = {nullptr};
+#define CurrentTCB CurrentTCBs[portGET_CORE_ID()]
+#endif
 
+#if (configNUMBER_OF_CORES == 1)
 static List_t<TCB_t> ReadyTasks[configMAX_PRIORITIES];
+#else
+// Every ready task is queued on the ready list of one core, normally the last one it ran on, so that a core only
+// looks at the other cores' lists to take work from them.
+static List_t<TCB_t> ReadyTasks[configNUMBER_OF_CORES][configMAX_PRIORITIES];
+#endif
+#if (configUSE_DELAYED_TASK_WHEEL == 1)
+static TimingWheel_t<TCB_t> DelayedWheel;
+#else
 static List_t<TCB_t> DelayedTasks1;
 static List_t<TCB_t> DelayedTasks2;
 static List_t<TCB_t> *volatile DelayedTasks;
 static List_t<TCB_t> *volatile OverflowDelayed;
+#endif
 static List_t<TCB_t> PendingReady;
 static List_t<TCB_t> TasksWaitingTermination;
 static volatile UBaseType_t DeletedTasksWaitingCleanUp = 0U;
@@ -108,18 +237,31 @@ static List_t<TCB_t> SuspendedTasks;
 
 static volatile UBaseType_t CurrentNumberOfTasks = 0U;
 static volatile TickType_t TickCount = (TickType_t)configINITIAL_TICK_COUNT;
-static volatile UBaseType_t TopReadyPriority = tskIDLE_PRIORITY;
+#if (configNUMBER_OF_CORES == 1)
+static ReadyBitmap_t TopReadyPriority;
+#else
+static ReadyBitmap_t TopReadyPriorities[configNUMBER_OF_CORES];
+#endif
 static volatile BaseType_t SchedulerRunning = false;
 static volatile TickType_t PendedTicks = 0U;
 static volatile BaseType_t YieldPendings[configNUMBER_OF_CORES] = {false};
 static volatile BaseType_t NOverflows = 0;
 static UBaseType_t TaskNumber = 0U;
 static volatile TickType_t NextTaskUnblockTime = 0U;
-static TaskHandle_t IdleTasks;
+static TaskHandle_t IdleTasks[configNUMBER_OF_CORES];
 
 static const volatile UBaseType_t TopUsedPriority = configMAX_PRIORITIES - 1U;
 
-static volatile bool SchedulerSuspended = false;
+static volatile UBaseType_t SchedulerSuspended = 0U;
+#if (configUSE_EDF_SCHEDULING == 1)
+static DeadlineHeap_t EDFReady;
+static UBaseType_t EDFTasks = 0U;
+#endif
+#if (configUSE_TASK_BUDGETS == 1)
+// Tasks that have spent their budget and wait for its replenishment, and the earliest replenishment among them.
+static List_t<TCB_t> ThrottledTasks;
+static TickType_t NextReplenishTime = 0U;
+#endif
 struct TCB_t {
   volatile StackType_t *StackTop;
   Item_t<TCB_t> StateListItem;
@@ -129,11 +271,53 @@ struct TCB_t {
   char Name[configMAX_TASK_NAME_LEN];
   UBaseType_t CriticalNesting;
   UBaseType_t BasePriority;
-  UBaseType_t MutexesHeld;
+  // The mutexes the task holds, and the mutex it last blocked on.
+  List_t<MutexLink_t> HeldMutexes;
+  MutexLink_t *BlockedOn;
   volatile uint32_t NotifiedValue[configTASK_NOTIFICATION_ARRAY_ENTRIES];
   volatile uint8_t NotifyState[configTASK_NOTIFICATION_ARRAY_ENTRIES];
   uint8_t StaticallyAllocated;
   uint8_t DelayAborted;
+  // Set when a condition variable notify, rather than a timeout, ended the task's last wait on it.
+  uint8_t Signalled;
+#if (configNUMBER_OF_CORES > 1)
+  // The core the task is running on, or taskTASK_NOT_RUNNING.
+  volatile BaseType_t TaskRunState;
+  // The core whose ready list the task is queued on when it is ready.
+  BaseType_t ReadyCore;
+#endif
+#if (configUSE_CORE_AFFINITY == 1)
+  UBaseType_t CoreAffinityMask;
+#endif
+#if (configUSE_EDF_SCHEDULING == 1)
+  // Zero for a fixed priority task.
+  TickType_t RelativeDeadline;
+  TickType_t Period;
+  TickType_t AbsoluteDeadline;
+  UBaseType_t DeadlineMisses;
+  // Slot in EDFReady, or taskEDF_NOT_QUEUED.
+  UBaseType_t HeapIndex;
+#endif
+#if (configUSE_TASK_BUDGETS == 1)
+  // In ThrottledTasks while the budget is spent.
+  Item_t<TCB_t> BudgetListItem;
+  // Zero for a task without a budget.
+  TickType_t Budget;
+  TickType_t BudgetPeriod;
+  TickType_t BudgetLeft;
+  // When the budget is next restored, valid once some of it has been spent.
+  TickType_t ReplenishTime;
+  uint8_t Throttled;
+#endif
+#if (configUSE_TASK_TIME_SLICE == 1)
+  // Ticks the task runs before giving way to a ready task of equal priority, and the ticks left of its current slice.
+  TickType_t TimeSlice;
+  TickType_t SliceLeft;
+#endif
+#if (configUSE_QUEUE_HANDOFF == 1)
+  // Where a sender may put an item for the task while it waits on a queue to receive one, or NULL.
+  void *HandoffBuffer;
+#endif
 
   bool Suspended() const {
     if (StateListItem.Container != &SuspendedTasks) {
@@ -163,43 +347,525 @@ struct TCB_t {
     }
   }
 
-  bool PriorityDisinherit() {
-    MutexesHeld--;
-    if (Priority == BasePriority) {
-      return false;
-    }
-    if (MutexesHeld > 0) {
-      return false;
+  // The priority the task runs at when it has not inherited a higher one.
+  UBaseType_t RestPriority() const {
+#if (configUSE_TASK_BUDGETS == 1)
+    if (Throttled && (BasePriority > (UBaseType_t)configBUDGET_EXHAUSTED_PRIORITY)) {
+      return (UBaseType_t)configBUDGET_EXHAUSTED_PRIORITY;
     }
-    if (StateListItem.remove() == 0) {
-      portRESET_READY_PRIORITY(Priority, TopReadyPriority);
+#endif
+    return BasePriority;
+  }
+
+  // The holder of the mutex the task is waiting for, or NULL if it is not waiting for one.
+  TCB_t *BlockingHolder() const {
+    if ((BlockedOn != NULL) && (EventListItem.Container == BlockedOn->Waiters)) {
+      return BlockedOn->Holder;
     }
-    Priority = BasePriority;
-    EventListItem.Value = (TickType_t)configMAX_PRIORITIES - (TickType_t)Priority;
-    AddTaskToReadyList(this);
-    return true;
+    return NULL;
   }
 };
 
+static_assert(sizeof(StaticTask_t) >= sizeof(TCB_t), "StaticTask_t must be large enough to hold a TCB_t");
+
+// Counts Ticks off the slice of a running task, and returns true once the task has used it up.
+static inline bool SliceExpired(TCB_t *TCB, const TickType_t Ticks) {
+#if (configUSE_TASK_TIME_SLICE == 1)
+  if (TCB->SliceLeft > Ticks) {
+    TCB->SliceLeft -= Ticks;
+    return false;
+  }
+  TCB->SliceLeft = TCB->TimeSlice;
+#else
+  (void)TCB;
+  (void)Ticks;
+#endif
+  return true;
+}
+
+#if (configUSE_EDF_SCHEDULING == 1)
+void DeadlineHeap_t::place(TCB_t *TCB, const UBaseType_t Slot) {
+  Tasks[Slot] = TCB;
+  TCB->HeapIndex = Slot;
+}
+
+void DeadlineHeap_t::siftUp(UBaseType_t Slot) {
+  TCB_t *const TCB = Tasks[Slot];
+  while (Slot > 0U) {
+    const UBaseType_t Parent = (Slot - 1U) / 2U;
+    if (!TickBefore(TCB->AbsoluteDeadline, Tasks[Parent]->AbsoluteDeadline)) {
+      break;
+    }
+    place(Tasks[Parent], Slot);
+    Slot = Parent;
+  }
+  place(TCB, Slot);
+}
+
+void DeadlineHeap_t::siftDown(UBaseType_t Slot) {
+  TCB_t *const TCB = Tasks[Slot];
+  for (;;) {
+    UBaseType_t Child = (2U * Slot) + 1U;
+    if (Child >= Count) {
+      break;
+    }
+    if ((Child + 1U < Count) && TickBefore(Tasks[Child + 1U]->AbsoluteDeadline, Tasks[Child]->AbsoluteDeadline)) {
+      Child++;
+    }
+    if (!TickBefore(Tasks[Child]->AbsoluteDeadline, TCB->AbsoluteDeadline)) {
+      break;
+    }
+    place(Tasks[Child], Slot);
+    Slot = Child;
+  }
+  place(TCB, Slot);
+}
+
+void DeadlineHeap_t::update(TCB_t *TCB) {
+  if (TCB->HeapIndex == taskEDF_NOT_QUEUED) {
+    place(TCB, Count++);
+    siftUp(TCB->HeapIndex);
+  } else {
+    siftUp(TCB->HeapIndex);
+    siftDown(TCB->HeapIndex);
+  }
+}
+
+void DeadlineHeap_t::remove(TCB_t *TCB) {
+  const UBaseType_t Slot = TCB->HeapIndex;
+  if (Slot == taskEDF_NOT_QUEUED) {
+    return;
+  }
+  TCB->HeapIndex = taskEDF_NOT_QUEUED;
+  Count--;
+  if (Slot < Count) {
+    TCB_t *const Moved = Tasks[Count];
+    place(Moved, Slot);
+    siftUp(Slot);
+    siftDown(Moved->HeapIndex);
+  }
+}
+
+TCB_t *DeadlineHeap_t::earliest() {
+  while (Count > 0U) {
+    TCB_t *const TCB = Tasks[0];
+    if (taskIS_EDF_TASK(TCB) && (TCB->StateListItem.Container == &ReadyTasks[configEDF_PRIORITY])) {
+      return TCB;
+    }
+    remove(TCB);
+  }
+  return NULL;
+}
+
+// Counts a miss for every ready EDF task whose deadline has come without it blocking for its next period, and moves
+// that deadline on by whole periods past the tick count so that an overrunning task does not keep precedence over
+// tasks that are on time. Returns true if any deadline moved.
+static BaseType_t CheckDeadlines(void) {
+  BaseType_t Missed = false;
+  TCB_t *TCB;
+  while (((TCB = EDFReady.earliest()) != NULL) && !TickBefore(TickCount, TCB->AbsoluteDeadline)) {
+    const TickType_t Late = TickCount - TCB->AbsoluteDeadline;
+    TCB->DeadlineMisses++;
+    TCB->AbsoluteDeadline += ((Late / TCB->Period) + 1U) * TCB->Period;
+    EDFReady.update(TCB);
+    Missed = true;
+  }
+  return Missed;
+}
+#endif
+
 static void ResetNextTaskUnblockTime();
 static inline void switchDelayedLists() {
+#if (configUSE_DELAYED_TASK_WHEEL == 0)
   List_t<TCB_t> *Temp;
   Temp = DelayedTasks;
   DelayedTasks = OverflowDelayed;
   OverflowDelayed = Temp;
+#endif
   NOverflows++;
   ResetNextTaskUnblockTime();
 }
 
+#if (configNUMBER_OF_CORES == 1)
+// At configEDF_PRIORITY the EDF task with the earliest deadline runs, and fixed priority tasks sharing that priority
+// only run when no EDF task is ready.
 static inline void selectHighestPriorityTask() {
-  UBaseType_t topPri;
-  portGET_HIGHEST_PRIORITY(topPri, TopReadyPriority);
+  const UBaseType_t topPri = TopReadyPriority.highest();
+#if (configUSE_EDF_SCHEDULING == 1)
+  if (topPri == (UBaseType_t)configEDF_PRIORITY) {
+    TCB_t *const TCB = EDFReady.earliest();
+    if (TCB != NULL) {
+      CurrentTCB = TCB;
+      return;
+    }
+  }
+#endif
   CurrentTCB = ReadyTasks[topPri].advance()->Owner;
 }
 
+static inline BaseType_t YieldForTask(const TCB_t *TCB) {
+#if (configUSE_EDF_SCHEDULING == 1)
+  if (taskIS_EDF_TASK(TCB) && (CurrentTCB->Priority == TCB->Priority)) {
+    return !taskIS_EDF_TASK(CurrentTCB) || TickBefore(TCB->AbsoluteDeadline, CurrentTCB->AbsoluteDeadline);
+  }
+#endif
+  return TCB->Priority > CurrentTCB->Priority;
+}
+
+// An EDF task is only switched out by an earlier deadline, never time sliced.
+static inline BaseType_t TimeSliceCores(const TickType_t Ticks) {
+#if (configUSE_EDF_SCHEDULING == 1)
+  if (taskIS_EDF_TASK(CurrentTCB)) {
+    return false;
+  }
+#endif
+  return SliceExpired(CurrentTCB, Ticks) && (ReadyTasks[CurrentTCB->Priority].Length > 1U);
+}
+
+static inline const ReadyBitmap_t &ReadyPriorities() { return TopReadyPriority; }
+
+static inline UBaseType_t ReadyTaskCount(const UBaseType_t Priority) { return ReadyTasks[Priority].Length; }
+#else
+static inline BaseType_t TaskCanRunOn(const TCB_t *TCB, const BaseType_t CoreID) {
+#if (configUSE_CORE_AFFINITY == 1)
+  return (TCB->CoreAffinityMask & ((UBaseType_t)1U << (UBaseType_t)CoreID)) != 0U;
+#else
+  (void)TCB;
+  (void)CoreID;
+  return true;
+#endif
+}
+
+static BaseType_t YieldForTask(const TCB_t *TCB);
+
+#if (configUSE_TICKLESS_IDLE != 0) || (configUSE_VIRTUAL_TIME == 1)
+static ReadyBitmap_t ReadyPriorities() {
+  ReadyBitmap_t Ready = TopReadyPriorities[0];
+  for (BaseType_t CoreID = 1; CoreID < (BaseType_t)configNUMBER_OF_CORES; CoreID++) {
+    Ready.merge(TopReadyPriorities[CoreID]);
+  }
+  return Ready;
+}
+#endif
+
+static UBaseType_t ReadyTaskCount(const UBaseType_t Priority) {
+  UBaseType_t Count = 0U;
+  for (BaseType_t CoreID = 0; CoreID < (BaseType_t)configNUMBER_OF_CORES; CoreID++) {
+    Count += ReadyTasks[CoreID][Priority].Length;
+  }
+  return Count;
+}
+
+// Requeues a ready task that is not running on the ready list of another core.
+static void MoveToReadyCore(TCB_t *TCB, const BaseType_t CoreID) {
+  if (TCB->StateListItem.remove() == 0) {
+    taskTOP_READY_PRIORITY(TCB).reset(TCB->Priority);
+  }
+  TCB->ReadyCore = CoreID;
+  AddTaskToReadyList(TCB);
+}
+
+#if (configUSE_CORE_AFFINITY == 1)
+// Makes sure a task that is not running is queued on a core it may run on, if there is one.
+static void MoveToAllowedCore(TCB_t *TCB) {
+  BaseType_t CoreID = 0;
+  while ((CoreID < (BaseType_t)configNUMBER_OF_CORES) && !TaskCanRunOn(TCB, CoreID)) {
+    CoreID++;
+  }
+  if ((CoreID == (BaseType_t)configNUMBER_OF_CORES) || TaskCanRunOn(TCB, TCB->ReadyCore)) {
+    return;
+  }
+  if (TCB->StateListItem.Container == &taskREADY_LIST(TCB, TCB->Priority)) {
+    MoveToReadyCore(TCB, CoreID);
+  } else {
+    TCB->ReadyCore = CoreID;
+  }
+}
+#endif
+
+// Finds the highest priority task queued on core From, no lower than MinPriority, that core To may take.
+static TCB_t *FindTaskToSteal(const BaseType_t From, const BaseType_t To, const UBaseType_t MinPriority) {
+  ReadyBitmap_t Ready = TopReadyPriorities[From];
+  while (!Ready.empty()) {
+    const UBaseType_t topPri = Ready.highest();
+    if (topPri < MinPriority) {
+      break;
+    }
+    List_t<TCB_t> *const List = &ReadyTasks[From][topPri];
+    for (Item_t<TCB_t> *Item = List->head(); Item != &List->End; Item = Item->Next) {
+      if ((Item->Owner->TaskRunState == taskTASK_NOT_RUNNING) && TaskCanRunOn(Item->Owner, To)) {
+        return Item->Owner;
+      }
+    }
+    Ready.reset(topPri);
+  }
+  return NULL;
+}
+
+// Picks the highest priority task queued on the core, rotating through tasks of equal priority, unless another core
+// has a higher priority task queued that may run here, in which case that task is moved over. A task of equal
+// priority is also taken from another core when this core would otherwise keep running the same task, or when the
+// core it is queued on is busy with a higher priority task, so that time slicing reaches every task of a priority.
+// While the scheduler runs there is always an idle task left for every core.
+static void selectHighestPriorityTask(const BaseType_t CoreID) {
+  TCB_t *const Previous = CurrentTCBs[CoreID];
+  TCB_t *Next = NULL;
+  ReadyBitmap_t Ready = TopReadyPriorities[CoreID];
+  while ((Next == NULL) && !Ready.empty()) {
+    const UBaseType_t topPri = Ready.highest();
+    List_t<TCB_t> *const List = &ReadyTasks[CoreID][topPri];
+    for (UBaseType_t n = List->Length; (Next == NULL) && (n > 0U); n--) {
+      TCB_t *const TCB = List->advance()->Owner;
+      if (TaskCanRunOn(TCB, CoreID) && ((TCB->TaskRunState == taskTASK_NOT_RUNNING) || (TCB == Previous))) {
+        Next = TCB;
+      }
+    }
+    Ready.reset(topPri);
+  }
+
+  UBaseType_t MinPriority = (Next == NULL) ? tskIDLE_PRIORITY : Next->Priority + 1U;
+  TCB_t *Stolen = NULL;
+  for (BaseType_t n = 1; n < (BaseType_t)configNUMBER_OF_CORES; n++) {
+    const BaseType_t From = (CoreID + n) % (BaseType_t)configNUMBER_OF_CORES;
+    const TCB_t *const Busy = CurrentTCBs[From];
+    UBaseType_t Min = MinPriority;
+    if ((Stolen == NULL) && (Next != NULL) &&
+        ((Next == Previous) || ((Busy != NULL) && (Busy->Priority > Next->Priority)))) {
+      Min = Next->Priority;
+    }
+    TCB_t *const TCB = FindTaskToSteal(From, CoreID, Min);
+    if (TCB != NULL) {
+      Stolen = TCB;
+      MinPriority = TCB->Priority + 1U;
+    }
+  }
+  if (Stolen != NULL) {
+    MoveToReadyCore(Stolen, CoreID);
+    ReadyTasks[CoreID][Stolen->Priority].Index = &Stolen->StateListItem;
+    Next = Stolen;
+  } else if (Next == NULL) {
+    // Only once TaskEndScheduler() has deleted the idle tasks.
+    return;
+  }
+
+  if ((Previous != NULL) && (Previous != Next)) {
+    Previous->TaskRunState = taskTASK_NOT_RUNNING;
+#if (configUSE_CORE_AFFINITY == 1)
+    // The core asked to yield runs the lowest priority task of all the cores the new task may use, which need not be
+    // the lowest of the cores the task being switched out may use.
+    if (Previous->StateListItem.Container == &taskREADY_LIST(Previous, Previous->Priority)) {
+      MoveToAllowedCore(Previous);
+      (void)YieldForTask(Previous);
+    }
+#endif
+  }
+  Next->TaskRunState = CoreID;
+  CurrentTCBs[CoreID] = Next;
+}
+
+// The calling core reschedules when it next leaves the kernel, any other core is interrupted.
+static void YieldCore(const BaseType_t CoreID) {
+  if (CoreID == (BaseType_t)portGET_CORE_ID()) {
+    YieldPendings[CoreID] = true;
+  } else if (!YieldPendings[CoreID]) {
+    YieldPendings[CoreID] = true;
+    portYIELD_CORE(CoreID);
+  }
+}
+
+// Asks the core running the lowest priority task below TCB's priority to reschedule, preferring the calling core on
+// a tie. Returns true if that is the calling core.
+static BaseType_t YieldForTask(const TCB_t *TCB) {
+  const BaseType_t Self = (BaseType_t)portGET_CORE_ID();
+  BaseType_t Target = -1;
+  UBaseType_t LowestPriority = TCB->Priority;
+  for (BaseType_t n = 0; n < (BaseType_t)configNUMBER_OF_CORES; n++) {
+    const BaseType_t CoreID = (Self + n) % (BaseType_t)configNUMBER_OF_CORES;
+    const TCB_t *const Running = CurrentTCBs[CoreID];
+    if ((Running != NULL) && (Running->Priority < LowestPriority) && TaskCanRunOn(TCB, CoreID) &&
+        !(YieldPendings[CoreID] && (CoreID != Self))) {
+      LowestPriority = Running->Priority;
+      Target = CoreID;
+    }
+  }
+  if (Target < 0) {
+    return false;
+  }
+  YieldCore(Target);
+  return Target == Self;
+}
+
+// Time slices every core whose task has used up its slice and whose priority has more ready tasks than there are cores
+// running it.
+static BaseType_t TimeSliceCores(const TickType_t Ticks) {
+  const BaseType_t Self = (BaseType_t)portGET_CORE_ID();
+  BaseType_t SwitchRequired = false;
+  for (BaseType_t CoreID = 0; CoreID < (BaseType_t)configNUMBER_OF_CORES; CoreID++) {
+    if (!SliceExpired(CurrentTCBs[CoreID], Ticks)) {
+      continue;
+    }
+    const UBaseType_t Priority = CurrentTCBs[CoreID]->Priority;
+    UBaseType_t Running = 0U;
+    for (BaseType_t Other = 0; Other < (BaseType_t)configNUMBER_OF_CORES; Other++) {
+      if (CurrentTCBs[Other]->Priority == Priority) {
+        Running++;
+      }
+    }
+    if (ReadyTaskCount(Priority) > Running) {
+      if (CoreID == Self) {
+        SwitchRequired = true;
+      } else {
+        YieldCore(CoreID);
+      }
+    }
+  }
+  return SwitchRequired;
+}
+#endif
+
+// Gives a task's event list item the value its priority calls for. A task that waits for a mutex keeps its place in
+// priority order among the waiters, as the holder inherits from the first, and one on a bucketed event list has to
+// leave its bucket before the value changes.
+static void SetEventListPriority(TCB_t *TCB) {
+  Item_t<TCB_t> *const Item = &TCB->EventListItem;
+  if ((Item->Value & taskEVENT_LIST_ITEM_VALUE_IN_USE) != 0U) {
+    return;
+  }
+  List_t<TCB_t> *const List = Item->Container;
+  bool Requeue = TCB->BlockingHolder() != NULL;
+#if (configUSE_PRIORITY_EVENT_LISTS == 1)
+  Requeue = Requeue || ((List != NULL) && (List->Buckets != NULL));
+#endif
+  if (Requeue) {
+    Item->remove();
+  }
+  Item->Value = (TickType_t)configMAX_PRIORITIES - (TickType_t)TCB->Priority;
+  if (Requeue) {
+    List->insert(Item);
+  }
+}
+
+// Moves a task to another priority, requeueing it if it is ready.
+static void MoveToPriority(TCB_t *TCB, const UBaseType_t NewPriority) {
+  if (TCB->StateListItem.Container == &taskREADY_LIST(TCB, TCB->Priority)) {
+    if (TCB->StateListItem.remove() == 0) {
+      taskTOP_READY_PRIORITY(TCB).reset(TCB->Priority);
+    }
+    TCB->Priority = NewPriority;
+    AddTaskToReadyList(TCB);
+  } else {
+    TCB->Priority = NewPriority;
+  }
+  SetEventListPriority(TCB);
+}
+
+// The priority a task is owed: its rest priority, or the ceiling or first waiter of a mutex it holds if higher.
+static UBaseType_t InheritedPriority(TCB_t *TCB) {
+  UBaseType_t Priority = TCB->RestPriority();
+  for (Item_t<MutexLink_t> *Item = TCB->HeldMutexes.head(); Item != &TCB->HeldMutexes.End; Item = Item->Next) {
+    List_t<TCB_t> *const Waiters = Item->Owner->Waiters;
+    if (Item->Owner->Ceiling > Priority) {
+      Priority = Item->Owner->Ceiling;
+    }
+    if (!Waiters->empty() && (Waiters->head()->Owner->Priority > Priority)) {
+      Priority = Waiters->head()->Owner->Priority;
+    }
+  }
+  return Priority;
+}
+
+// Gives a task the priority it is owed, and passes the change on down the chain of holders of the mutexes it waits
+// for. Returns true if the task's own priority changed.
+static bool UpdateInheritance(TCB_t *const Task) {
+  const UBaseType_t PriorityOnEntry = Task->Priority;
+  for (TCB_t *TCB = Task; TCB != NULL; TCB = TCB->BlockingHolder()) {
+    const UBaseType_t NewPriority = InheritedPriority(TCB);
+    if (NewPriority == TCB->Priority) {
+      break;
+    }
+    MoveToPriority(TCB, NewPriority);
+  }
+  return Task->Priority != PriorityOnEntry;
+}
+
+#if (configUSE_TASK_BUDGETS == 1)
+// Drops a running task that has spent its budget to configBUDGET_EXHAUSTED_PRIORITY, or to the priority it inherits
+// if that is higher.
+static void ThrottleTask(TCB_t *TCB) {
+  TCB->Throttled = (uint8_t) true;
+  ThrottledTasks.append(&TCB->BudgetListItem);
+  if ((ThrottledTasks.Length == 1U) || TickBefore(TCB->ReplenishTime, NextReplenishTime)) {
+    NextReplenishTime = TCB->ReplenishTime;
+  }
+  if (UpdateInheritance(TCB)) {
+#if (configNUMBER_OF_CORES == 1)
+    YieldPendings[0] = true;
+#else
+    YieldCore(TCB->TaskRunState);
+#endif
+  }
+}
+
+static void UnthrottleTask(TCB_t *TCB) {
+  TCB->BudgetListItem.remove();
+  TCB->Throttled = (uint8_t) false;
+  if (UpdateInheritance(TCB)) {
+    if (!taskTASK_IS_RUNNING(TCB) && (TCB->StateListItem.Container == &taskREADY_LIST(TCB, TCB->Priority)) &&
+        YieldForTask(TCB)) {
+      YieldPendings[portGET_CORE_ID()] = true;
+    }
+  }
+}
+
+// A task's budget period starts at the first tick it is charged for once its budget is full, as for a sporadic server
+// with a single replenishment. The full budget is restored when the period ends.
+static void ChargeBudget(TCB_t *TCB, const TickType_t Ticks) {
+  if ((TCB == NULL) || (TCB->Budget == 0U) || TCB->Throttled) {
+    return;
+  }
+  if ((TCB->BudgetLeft == TCB->Budget) || !TickBefore(TickCount, TCB->ReplenishTime)) {
+    TCB->BudgetLeft = TCB->Budget;
+    TCB->ReplenishTime = TickCount + TCB->BudgetPeriod;
+  }
+  TCB->BudgetLeft -= (Ticks < TCB->BudgetLeft) ? Ticks : TCB->BudgetLeft;
+  if (TCB->BudgetLeft == 0U) {
+    ThrottleTask(TCB);
+  }
+}
+
+// Charges the tasks running on every core for Ticks ticks, and restores the budgets that are due.
+static void ChargeRunningTasks(const TickType_t Ticks) {
+#if (configNUMBER_OF_CORES == 1)
+  ChargeBudget(CurrentTCB, Ticks);
+#else
+  for (BaseType_t CoreID = 0; CoreID < (BaseType_t)configNUMBER_OF_CORES; CoreID++) {
+    ChargeBudget(CurrentTCBs[CoreID], Ticks);
+  }
+#endif
+  if (ThrottledTasks.empty() || TickBefore(TickCount, NextReplenishTime)) {
+    return;
+  }
+  bool HaveNext = false;
+  for (Item_t<TCB_t> *Item = ThrottledTasks.head(); Item != &ThrottledTasks.End;) {
+    TCB_t *const TCB = Item->Owner;
+    Item = Item->Next;
+    if (!TickBefore(TickCount, TCB->ReplenishTime)) {
+      TCB->BudgetLeft = TCB->Budget;
+      UnthrottleTask(TCB);
+    } else if (!HaveNext || TickBefore(TCB->ReplenishTime, NextReplenishTime)) {
+      NextReplenishTime = TCB->ReplenishTime;
+      HaveNext = true;
+    }
+  }
+}
+#endif
+
 static BaseType_t CreateIdleTasks(void);
 static void InitialiseTaskLists(void);
 static portTASK_FUNCTION_PROTO(IdleTask, Params);
+#if (configNUMBER_OF_CORES > 1)
+static portTASK_FUNCTION_PROTO(PassiveIdleTask, Params);
+#endif
 
 static void CheckTasksWaitingTermination(void);
 
@@ -207,6 +873,18 @@ static void AddCurrentTaskToDelayedList(TickType_t TicksToWait, const BaseType_t
 
 static void ResetNextTaskUnblockTime(void);
 
+static BaseType_t UnblockExpiredTasks(const TickType_t Now);
+
+static BaseType_t AdvanceTicks(TickType_t Ticks);
+
+#if (configUSE_VIRTUAL_TIME == 1)
+static void AdvanceVirtualTime(void);
+#endif
+
+#if (configUSE_TICKLESS_IDLE != 0)
+static TickType_t GetExpectedIdleTime(void);
+#endif
+
 static void InitialiseNewTask(TaskFunction_t TaskCode, const char *const Name, const configSTACK_DEPTH_TYPE StackDepth,
                               void *const Params, UBaseType_t Priority, TaskHandle_t *const CreatedTask, TCB_t *NewTCB,
                               const MemoryRegion_t *const xRegions);
@@ -310,8 +988,39 @@ static void InitialiseNewTask(TaskFunction_t TaskCode, const char *const Name, c
   NewTCB->StateListItem.Owner = NewTCB;
   NewTCB->EventListItem.Value = (TickType_t)configMAX_PRIORITIES - (TickType_t)Priority;
   NewTCB->EventListItem.Owner = NewTCB;
+  NewTCB->HeldMutexes.init();
+  NewTCB->BlockedOn = NULL;
+#if (configUSE_QUEUE_HANDOFF == 1)
+  NewTCB->HandoffBuffer = NULL;
+#endif
+#if (configNUMBER_OF_CORES > 1)
+  NewTCB->TaskRunState = taskTASK_NOT_RUNNING;
+  NewTCB->ReadyCore = (BaseType_t)portGET_CORE_ID();
+#endif
+#if (configUSE_CORE_AFFINITY == 1)
+  NewTCB->CoreAffinityMask = tskNO_AFFINITY;
+#endif
+#if (configUSE_TASK_TIME_SLICE == 1)
+  NewTCB->TimeSlice = (TickType_t)configDEFAULT_TIME_SLICE;
+  NewTCB->SliceLeft = (TickType_t)configDEFAULT_TIME_SLICE;
+#endif
+#if (configUSE_TASK_BUDGETS == 1)
+  NewTCB->BudgetListItem.init();
+  NewTCB->BudgetListItem.Owner = NewTCB;
+  NewTCB->Budget = 0U;
+  NewTCB->Throttled = (uint8_t) false;
+#endif
+#if (configUSE_EDF_SCHEDULING == 1)
+  NewTCB->RelativeDeadline = 0U;
+  NewTCB->DeadlineMisses = 0U;
+  NewTCB->HeapIndex = taskEDF_NOT_QUEUED;
+#endif
   (void)xRegions;
+#if (portHAS_STACK_OVERFLOW_CHECKING == 1)
+  NewTCB->StackTop = PortInitialiseStack(StackTop, NewTCB->Stack, TaskCode, Params);
+#else
   NewTCB->StackTop = PortInitialiseStack(StackTop, TaskCode, Params);
+#endif
   if (CreatedTask != NULL) {
     *CreatedTask = (TaskHandle_t)NewTCB;
   }
@@ -336,11 +1045,11 @@ static void AddNewTaskToReadyList(TCB_t *NewTCB) {
     TaskNumber++;
     AddTaskToReadyList(NewTCB);
     portSETUP_TCB(NewTCB);
+    if (SchedulerRunning) {
+      taskYIELD_ANY_CORE_IF_USING_PREEMPTION(NewTCB);
+    }
   }
   EXIT_CRITICAL();
-  if (SchedulerRunning) {
-    taskYIELD_ANY_CORE_IF_USING_PREEMPTION(NewTCB);
-  }
 }
 
 void TaskDelete(TaskHandle_t TaskToDelete) {
@@ -351,16 +1060,35 @@ void TaskDelete(TaskHandle_t TaskToDelete) {
   {
     TCB = GetTCBFromHandle(TaskToDelete);
     if (TCB->StateListItem.remove() == 0) {
-      taskRESET_READY_PRIORITY(TCB->Priority);
+      taskRESET_READY_PRIORITY(TCB, TCB->Priority);
     }
     TCB->EventListItem.ensureRemoved();
+#if (configUSE_EDF_SCHEDULING == 1)
+    // The heap may hold on to a task that is not ready, so it has to let go before the TCB is freed.
+    EDFReady.remove(TCB);
+    if (TCB->RelativeDeadline != 0U) {
+      EDFTasks--;
+    }
+#endif
+#if (configUSE_TASK_BUDGETS == 1)
+    TCB->BudgetListItem.ensureRemoved();
+#endif
     TaskNumber++;
     TaskIsRunningOrYielding = taskTASK_IS_RUNNING_OR_SCHEDULED_TO_YIELD(TCB);
     if ((SchedulerRunning) && (TaskIsRunningOrYielding)) {
       TasksWaitingTermination.append(&TCB->StateListItem);
       ++DeletedTasksWaitingCleanUp;
       xDeleteTCBInIdleTask = true;
+#if (configNUMBER_OF_CORES == 1)
       portPRE_TASK_DELETE_HOOK(TCB, &(YieldPendings[0]));
+#else
+      {
+        BaseType_t PendYield = false;
+        portPRE_TASK_DELETE_HOOK(TCB, &PendYield);
+        (void)PendYield;
+        YieldCore(TCB->TaskRunState);
+      }
+#endif
     } else {
       --CurrentNumberOfTasks;
       ResetNextTaskUnblockTime();
@@ -396,6 +1124,16 @@ BaseType_t DelayUntil(TickType_t *const PreviousWakeTime, const TickType_t xTime
     }
 
     *PreviousWakeTime = TimeToWake;
+#if (configUSE_EDF_SCHEDULING == 1)
+    // The next job of a periodic EDF task is released at the wake time.
+    if (CurrentTCB->RelativeDeadline != 0U) {
+      CriticalSection s;
+      CurrentTCB->AbsoluteDeadline = TimeToWake + CurrentTCB->RelativeDeadline;
+      if (CurrentTCB->HeapIndex != taskEDF_NOT_QUEUED) {
+        EDFReady.update(CurrentTCB);
+      }
+    }
+#endif
     if (xShouldDelay) {
       AddCurrentTaskToDelayedList(TimeToWake - ConstTickCount, false);
     }
@@ -420,23 +1158,31 @@ TaskState TaskGetState(TaskHandle_t Task) {
   TaskState eReturn;
   List_t<TCB_t> *StateList;
   List_t<TCB_t> *EventList;
+#if (configUSE_DELAYED_TASK_WHEEL == 0)
   List_t<TCB_t> *DelayedList;
   List_t<TCB_t> *OverflowedDelayedList;
+#endif
   TCB_t *TCB = Task;
-  if (TCB == CurrentTCB) {
+  if (taskTASK_IS_RUNNING(TCB)) {
     eReturn = eRunning;
   } else {
     ENTER_CRITICAL();
     {
       StateList = TCB->StateListItem.Container;
       EventList = TCB->EventListItem.Container;
+#if (configUSE_DELAYED_TASK_WHEEL == 0)
       DelayedList = DelayedTasks;
       OverflowedDelayedList = OverflowDelayed;
+#endif
     }
     EXIT_CRITICAL();
     if (EventList == &PendingReady) {
       eReturn = eReady;
+#if (configUSE_DELAYED_TASK_WHEEL == 1)
+    } else if (DelayedWheel.contains(StateList)) {
+#else
     } else if ((StateList == DelayedList) || (StateList == OverflowedDelayedList)) {
+#endif
       eReturn = eBlocked;
     } else if (StateList == &SuspendedTasks) {
       if (TCB->EventListItem.Container == NULL) {
@@ -537,19 +1283,28 @@ void TaskPrioritySet(TaskHandle_t Task, UBaseType_t uxNewPriority) {
         xYieldRequired = true;
       }
       PriorityUsedOnEntry = TCB->Priority;
-      if ((TCB->BasePriority == TCB->Priority) || (uxNewPriority > TCB->Priority)) {
-        TCB->Priority = uxNewPriority;
-      }
       TCB->BasePriority = uxNewPriority;
-      if ((TCB->EventListItem.Value & taskEVENT_LIST_ITEM_VALUE_IN_USE) == 0U) {
-        TCB->EventListItem.Value = (TickType_t)configMAX_PRIORITIES - (TickType_t)uxNewPriority;
-      }
-      if (TCB->StateListItem.Container == &ReadyTasks[PriorityUsedOnEntry]) {
+      TCB->Priority = InheritedPriority(TCB);
+      SetEventListPriority(TCB);
+      if (TCB->StateListItem.Container == &taskREADY_LIST(TCB, PriorityUsedOnEntry)) {
         if (TCB->StateListItem.remove() == 0) {
-          portRESET_READY_PRIORITY(PriorityUsedOnEntry, TopReadyPriority);
+          taskTOP_READY_PRIORITY(TCB).reset(PriorityUsedOnEntry);
         }
         AddTaskToReadyList(TCB);
       }
+      if (TCB->BlockingHolder() != NULL) {
+        (void)UpdateInheritance(TCB->BlockingHolder());
+      }
+#if (configNUMBER_OF_CORES > 1)
+      if (taskTASK_IS_RUNNING(TCB)) {
+        if (xYieldRequired && (TCB != CurrentTCB)) {
+          YieldCore(TCB->TaskRunState);
+          xYieldRequired = false;
+        }
+      } else if ((uxNewPriority > uxCurrentBasePriority) && (TCB->StateListItem.Container == &taskREADY_LIST(TCB, TCB->Priority))) {
+        xYieldRequired = YieldForTask(TCB);
+      }
+#endif
       if (xYieldRequired) {
         portYIELD_WITHIN_API();
       }
@@ -559,17 +1314,131 @@ void TaskPrioritySet(TaskHandle_t Task, UBaseType_t uxNewPriority) {
   EXIT_CRITICAL();
 }
 
+#if (configUSE_CORE_AFFINITY == 1)
+void TaskCoreAffinitySet(TaskHandle_t Task, UBaseType_t CoreAffinityMask) {
+  CriticalSection s;
+  TCB_t *const TCB = GetTCBFromHandle(Task);
+  const UBaseType_t PreviouslyAllowed = TCB->CoreAffinityMask;
+  TCB->CoreAffinityMask = CoreAffinityMask;
+  if (!taskTASK_IS_RUNNING(TCB)) {
+    MoveToAllowedCore(TCB);
+  }
+  if (SchedulerRunning) {
+    if (taskTASK_IS_RUNNING(TCB)) {
+      if (!TaskCanRunOn(TCB, TCB->TaskRunState)) {
+        YieldCore(TCB->TaskRunState);
+      }
+    } else if (((CoreAffinityMask & ~PreviouslyAllowed) != 0U) &&
+               (TCB->StateListItem.Container == &taskREADY_LIST(TCB, TCB->Priority))) {
+      (void)YieldForTask(TCB);
+    }
+    if (YieldPendings[portGET_CORE_ID()]) {
+      portYIELD_WITHIN_API();
+    }
+  }
+}
+
+UBaseType_t TaskCoreAffinityGet(const TaskHandle_t Task) {
+  CriticalSection s;
+  return GetTCBFromHandle(Task)->CoreAffinityMask;
+}
+#endif
+
+#if (configUSE_EDF_SCHEDULING == 1)
+// Moves the task to configEDF_PRIORITY and schedules it by deadline there, with its first deadline RelativeDeadline
+// ticks from now. A Period of zero makes the period equal to the deadline. A RelativeDeadline of zero turns the task
+// back into a fixed priority task, still at configEDF_PRIORITY. Fails when configEDF_MAX_TASKS tasks already use EDF.
+BaseType_t TaskSetDeadline(TaskHandle_t Task, TickType_t RelativeDeadline, TickType_t Period) {
+  CriticalSection s;
+  TCB_t *const TCB = GetTCBFromHandle(Task);
+  if (RelativeDeadline == 0U) {
+    if (TCB->RelativeDeadline != 0U) {
+      EDFReady.remove(TCB);
+      EDFTasks--;
+      TCB->RelativeDeadline = 0U;
+    }
+    return true;
+  }
+  if (TCB->RelativeDeadline == 0U) {
+    if (EDFTasks == (UBaseType_t)configEDF_MAX_TASKS) {
+      return false;
+    }
+    EDFTasks++;
+  }
+  TCB->RelativeDeadline = RelativeDeadline;
+  TCB->Period = (Period == 0U) ? RelativeDeadline : Period;
+  TCB->AbsoluteDeadline = TickCount + RelativeDeadline;
+  TaskPrioritySet(TCB, (UBaseType_t)configEDF_PRIORITY);
+  if ((TCB->HeapIndex != taskEDF_NOT_QUEUED) || (TCB->StateListItem.Container == &ReadyTasks[configEDF_PRIORITY])) {
+    EDFReady.update(TCB);
+  }
+  if (SchedulerRunning && ((TCB == CurrentTCB) || YieldForTask(TCB))) {
+    portYIELD_WITHIN_API();
+  }
+  return true;
+}
+
+UBaseType_t TaskGetDeadlineMisses(const TaskHandle_t Task) {
+  CriticalSection s;
+  return GetTCBFromHandle(Task)->DeadlineMisses;
+}
+#endif
+
+#if (configUSE_TASK_TIME_SLICE == 1)
+// A slice of zero ticks is taken as one.
+void TaskSetTimeSlice(TaskHandle_t Task, TickType_t Ticks) {
+  CriticalSection s;
+  TCB_t *const TCB = GetTCBFromHandle(Task);
+  TCB->TimeSlice = (Ticks == 0U) ? (TickType_t)1U : Ticks;
+  if (TCB->SliceLeft > TCB->TimeSlice) {
+    TCB->SliceLeft = TCB->TimeSlice;
+  }
+}
+
+TickType_t TaskGetTimeSlice(const TaskHandle_t Task) {
+  CriticalSection s;
+  return GetTCBFromHandle(Task)->TimeSlice;
+}
+#endif
+
+#if (configUSE_TASK_BUDGETS == 1)
+// Limits the task to Budget ticks of execution in every Period ticks. A task that spends its budget runs at
+// configBUDGET_EXHAUSTED_PRIORITY until the period it was spent in ends. A Budget of zero lifts the limit.
+BaseType_t TaskSetBudget(TaskHandle_t Task, TickType_t Budget, TickType_t Period) {
+  if ((Budget != 0U) && (Period < Budget)) {
+    return false;
+  }
+  CriticalSection s;
+  TCB_t *const TCB = GetTCBFromHandle(Task);
+  TCB->Budget = Budget;
+  TCB->BudgetPeriod = Period;
+  TCB->BudgetLeft = Budget;
+  if (TCB->Throttled) {
+    UnthrottleTask(TCB);
+    if (SchedulerRunning && YieldPendings[portGET_CORE_ID()]) {
+      portYIELD_WITHIN_API();
+    }
+  }
+  return true;
+}
+#endif
+
 void TaskSuspend(TaskHandle_t TaskToSuspend) {
   TCB_t *TCB;
   ENTER_CRITICAL();
   {
     TCB = GetTCBFromHandle(TaskToSuspend);
     if (TCB->StateListItem.remove() == 0) {
-      taskRESET_READY_PRIORITY(TCB->Priority);
+      taskRESET_READY_PRIORITY(TCB, TCB->Priority);
     }
     TCB->EventListItem.ensureRemoved();
 
     SuspendedTasks.append(&TCB->StateListItem);
+#if (configNUMBER_OF_CORES > 1)
+    if (SchedulerRunning && taskTASK_IS_RUNNING(TCB) && (TCB != CurrentTCB)) {
+      YieldCore(TCB->TaskRunState);
+    }
+#endif
     BaseType_t x;
     for (x = 0; x < (BaseType_t)configTASK_NOTIFICATION_ARRAY_ENTRIES; x++) {
       if (TCB->NotifyState[x] == taskWAITING_NOTIFICATION) {
@@ -623,12 +1492,12 @@ BaseType_t TaskResumeFromISR(TaskHandle_t TaskToResume) {
   {
     if (TCB->Suspended()) {
       if (SchedulerSuspended == 0U) {
-        if (TCB->Priority > CurrentTCB->Priority) {
-          xYieldRequired = true;
-          YieldPendings[0] = true;
-        }
         TCB->StateListItem.remove();
         AddTaskToReadyList(TCB);
+        if (YieldForTask(TCB)) {
+          xYieldRequired = true;
+          YieldPendings[portGET_CORE_ID()] = true;
+        }
       } else {
         PendingReady.append(&TCB->EventListItem);
       }
@@ -658,10 +1527,22 @@ static BaseType_t CreateIdleTasks(void) {
     StackType_t *IdleTaskStackBuffer = NULL;
     configSTACK_DEPTH_TYPE IdleTaskStackSize;
 
-    GetIdleTaskMemory(&pIdleTaskTCBBuffer, &IdleTaskStackBuffer, &IdleTaskStackSize);
-    IdleTasks = TaskCreateStatic(IdleTaskFunction, cIdleName, IdleTaskStackSize, (void *)NULL, portPRIVILEGE_BIT,
-                                 IdleTaskStackBuffer, pIdleTaskTCBBuffer);
-    if (IdleTasks != NULL) {
+#if (configNUMBER_OF_CORES > 1)
+    if (xIdleTaskNameIndex < (BaseType_t)configMAX_TASK_NAME_LEN - 1) {
+      cIdleName[xIdleTaskNameIndex] = (char)('0' + xCoreID);
+      cIdleName[xIdleTaskNameIndex + 1] = (char)0x00;
+    }
+    if (xCoreID > 0) {
+      IdleTaskFunction = PassiveIdleTask;
+      GetPassiveIdleTaskMemory(&pIdleTaskTCBBuffer, &IdleTaskStackBuffer, &IdleTaskStackSize, xCoreID - 1);
+    } else
+#endif
+    {
+      GetIdleTaskMemory(&pIdleTaskTCBBuffer, &IdleTaskStackBuffer, &IdleTaskStackSize);
+    }
+    IdleTasks[xCoreID] = TaskCreateStatic(IdleTaskFunction, cIdleName, IdleTaskStackSize, (void *)NULL,
+                                          portPRIVILEGE_BIT, IdleTaskStackBuffer, pIdleTaskTCBBuffer);
+    if (IdleTasks[xCoreID] != NULL) {
       Ret = true;
     } else {
       Ret = false;
@@ -687,6 +1568,19 @@ void TaskStartScheduler(void) {
     SchedulerRunning = true;
     TickCount = (TickType_t)configINITIAL_TICK_COUNT;
 
+#if (configNUMBER_OF_CORES > 1)
+    // Task creation only tracked the best task for the first core, so every core picks its task afresh.
+    for (BaseType_t xCoreID = 0; xCoreID < (BaseType_t)configNUMBER_OF_CORES; xCoreID++) {
+      CurrentTCBs[xCoreID] = NULL;
+    }
+    for (BaseType_t xCoreID = 0; xCoreID < (BaseType_t)configNUMBER_OF_CORES; xCoreID++) {
+      selectHighestPriorityTask(xCoreID);
+    }
+#elif (configUSE_EDF_SCHEDULING == 1)
+    // Task creation only compared priorities, not deadlines.
+    selectHighestPriorityTask();
+#endif
+
     portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
 
     (void)xPortStartScheduler();
@@ -701,7 +1595,9 @@ void TaskStartScheduler(void) {
 
 void TaskEndScheduler(void) {
   TaskDelete(TimerGetTimerDaemonTaskHandle());
-  TaskDelete(IdleTasks);
+  for (BaseType_t xCoreID = 0; xCoreID < (BaseType_t)configNUMBER_OF_CORES; xCoreID++) {
+    TaskDelete(IdleTasks[xCoreID]);
+  }
   CheckTasksWaitingTermination();
   portDISABLE_INTERRUPTS();
   SchedulerRunning = false;
@@ -710,9 +1606,23 @@ void TaskEndScheduler(void) {
 }
 
 void TaskSuspendAll(void) {
+#if (configNUMBER_OF_CORES == 1)
   portSOFTWARE_BARRIER();
   SchedulerSuspended = (UBaseType_t)(SchedulerSuspended + 1U);
   portMEMORY_BARRIER();
+#else
+  // The task lock keeps other cores out of the kernel until ResumeAll(), the ISR lock only guards the count itself.
+  if (SchedulerRunning) {
+    const UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+    portGET_TASK_LOCK();
+    portGET_ISR_LOCK();
+    SchedulerSuspended = (UBaseType_t)(SchedulerSuspended + 1U);
+    portRELEASE_ISR_LOCK();
+    portCLEAR_INTERRUPT_MASK(uxSavedInterruptStatus);
+  } else {
+    SchedulerSuspended = (UBaseType_t)(SchedulerSuspended + 1U);
+  }
+#endif
 }
 
 BaseType_t ResumeAll(void) {
@@ -735,7 +1645,7 @@ BaseType_t ResumeAll(void) {
             TCB->StateListItem.remove();
             AddTaskToReadyList(TCB);
             {
-              if (TCB->Priority > CurrentTCB->Priority) {
+              if (YieldForTask(TCB)) {
                 YieldPendings[xCoreID] = true;
               }
             }
@@ -747,12 +1657,9 @@ BaseType_t ResumeAll(void) {
           {
             TickType_t xPendedCounts = PendedTicks;
             if (xPendedCounts > 0U) {
-              do {
-                if (TaskIncrementTick()) {
-                  YieldPendings[xCoreID] = true;
-                }
-                --xPendedCounts;
-              } while (xPendedCounts > 0U);
+              if (AdvanceTicks(xPendedCounts)) {
+                YieldPendings[xCoreID] = true;
+              }
               PendedTicks = 0;
             }
           }
@@ -810,7 +1717,7 @@ BaseType_t TaskGetStaticBuffers(TaskHandle_t Task, StackType_t **pStackBuffer, S
   }
   return true;
 }
-TaskHandle_t TaskGetIdleTaskHandle(void) { return IdleTasks; }
+TaskHandle_t TaskGetIdleTaskHandle(void) { return IdleTasks[0]; }
 BaseType_t CatchUpTicks(TickType_t xTicksToCatchUp) {
   BaseType_t xYieldOccurred;
   TaskSuspendAll();
@@ -837,8 +1744,8 @@ BaseType_t AbortDelay(TaskHandle_t Task) {
       }
       EXIT_CRITICAL();
       AddTaskToReadyList(TCB);
-      if (TCB->Priority > CurrentTCB->Priority) {
-        YieldPendings[0] = true;
+      if (YieldForTask(TCB)) {
+        YieldPendings[portGET_CORE_ID()] = true;
       }
     } else {
       Ret = false;
@@ -848,9 +1755,86 @@ BaseType_t AbortDelay(TaskHandle_t Task) {
   return Ret;
 }
 
+#if (configUSE_DELAYED_TASK_WHEEL == 1)
+// The wheel only knows a lower bound on the next wake time above its first level, so it is advanced from one bound to
+// the next until Now is reached. Each step expires one slot.
+static BaseType_t UnblockExpiredTasks(const TickType_t Now) {
+  BaseType_t xSwitchRequired = false;
+  bool More;
+  do {
+    TickType_t Next;
+    More = DelayedWheel.nextExpiry(&Next) &&
+           ((TickType_t)(Next - DelayedWheel.Now) < (TickType_t)(Now - DelayedWheel.Now));
+    List_t<TCB_t> *const Expired = DelayedWheel.advance(More ? Next : Now);
+    while (!Expired->empty()) {
+      TCB_t *TCB = Expired->head()->Owner;
+      TCB->StateListItem.remove();
+      TCB->EventListItem.ensureRemoved();
+      AddTaskToReadyList(TCB);
+      if (YieldForTask(TCB)) {
+        xSwitchRequired = true;
+      }
+    }
+  } while (More);
+  ResetNextTaskUnblockTime();
+  return xSwitchRequired;
+}
+#else
+static BaseType_t UnblockExpiredTasks(const TickType_t Now) {
+  BaseType_t xSwitchRequired = false;
+  while (!DelayedTasks->empty()) {
+    TCB_t *TCB = DelayedTasks->head()->Owner;
+    if (Now < TCB->StateListItem.Value) {
+      break;
+    }
+    TCB->StateListItem.remove();
+    TCB->EventListItem.ensureRemoved();
+    AddTaskToReadyList(TCB);
+    if (YieldForTask(TCB)) {
+      xSwitchRequired = true;
+    }
+  }
+  ResetNextTaskUnblockTime();
+  return xSwitchRequired;
+}
+#endif
+
+// Same effect as calling TaskIncrementTick() Ticks times, but the cost depends on the number of tasks unblocked
+// rather than on Ticks: a tick count overflow swaps the delayed lists once and only expired tasks are visited.
+static BaseType_t AdvanceTicks(TickType_t Ticks) {
+  const TickType_t Elapsed = Ticks;
+  BaseType_t xSwitchRequired = false;
+  while (Ticks > (TickType_t)(portMAX_DELAY - TickCount)) {
+    Ticks -= (TickType_t)(portMAX_DELAY - TickCount) + (TickType_t)1;
+    TickCount = portMAX_DELAY;
+    if (UnblockExpiredTasks(portMAX_DELAY)) {
+      xSwitchRequired = true;
+    }
+    TickCount = 0;
+    switchDelayedLists();
+  }
+  TickCount += Ticks;
+  if ((TickCount >= NextTaskUnblockTime) && UnblockExpiredTasks(TickCount)) {
+    xSwitchRequired = true;
+  }
+#if (configUSE_EDF_SCHEDULING == 1)
+  if (CheckDeadlines()) {
+    xSwitchRequired = true;
+  }
+#endif
+#if (configUSE_TASK_BUDGETS == 1)
+  ChargeRunningTasks(Elapsed);
+#endif
+  if (TimeSliceCores(Elapsed)) {
+    xSwitchRequired = true;
+  }
+  if (YieldPendings[portGET_CORE_ID()]) {
+    xSwitchRequired = true;
+  }
+  return xSwitchRequired;
+}
+
 BaseType_t TaskIncrementTick(void) {
-  TCB_t *TCB;
-  TickType_t Value;
   BaseType_t xSwitchRequired = false;
   if (SchedulerSuspended == 0U) {
     const TickType_t ConstTickCount = TickCount + (TickType_t)1;
@@ -859,33 +1843,23 @@ BaseType_t TaskIncrementTick(void) {
       switchDelayedLists();
     }
     if (ConstTickCount >= NextTaskUnblockTime) {
-      for (;;) {
-        if (DelayedTasks->empty()) {
-          NextTaskUnblockTime = portMAX_DELAY;
-          break;
-        } else {
-          TCB = DelayedTasks->head()->Owner;
-          Value = TCB->StateListItem.Value;
-          if (ConstTickCount < Value) {
-            NextTaskUnblockTime = Value;
-            break;
-          }
-          TCB->StateListItem.remove();
-          TCB->EventListItem.ensureRemoved();
-          AddTaskToReadyList(TCB);
-          if (TCB->Priority > CurrentTCB->Priority) {
-            xSwitchRequired = true;
-          }
-        }
-      }
+      xSwitchRequired = UnblockExpiredTasks(ConstTickCount);
     }
-    if (ReadyTasks[CurrentTCB->Priority].Length > 1U) {
+#if (configUSE_EDF_SCHEDULING == 1)
+    if (CheckDeadlines()) {
+      xSwitchRequired = true;
+    }
+#endif
+#if (configUSE_TASK_BUDGETS == 1)
+    ChargeRunningTasks(1U);
+#endif
+    if (TimeSliceCores(1U)) {
       xSwitchRequired = true;
     }
     if (PendedTicks == (TickType_t)0) {
       ApplicationTickHook();
     }
-    if (YieldPendings[0]) {
+    if (YieldPendings[portGET_CORE_ID()]) {
       xSwitchRequired = true;
     }
   } else {
@@ -900,11 +1874,25 @@ BaseType_t TaskIncrementTick(void) {
 }
 
 void SwitchContext(void) {
+  const BaseType_t xCoreID = (BaseType_t)portGET_CORE_ID();
   if (SchedulerSuspended != 0U) {
-    YieldPendings[0] = true;
+    YieldPendings[xCoreID] = true;
   } else {
-    YieldPendings[0] = false;
+    YieldPendings[xCoreID] = false;
+#if (configUSE_TASK_TIME_SLICE == 1)
+    TCB_t *const Previous = CurrentTCB;
+#endif
+#if (configNUMBER_OF_CORES == 1)
     selectHighestPriorityTask();
+#else
+    selectHighestPriorityTask(xCoreID);
+#endif
+#if (configUSE_TASK_TIME_SLICE == 1)
+    // A task starts a fresh slice whenever it gets the core back.
+    if (CurrentTCB != Previous) {
+      CurrentTCB->SliceLeft = CurrentTCB->TimeSlice;
+    }
+#endif
     portTASK_SWITCH_HOOK(CurrentTCB);
   }
 }
@@ -926,7 +1914,7 @@ void PlaceOnEventListRestricted(List_t<TCB_t> *const EventList, TickType_t Ticks
   AddCurrentTaskToDelayedList(xWaitIndefinitely ? portMAX_DELAY : TicksToWait, xWaitIndefinitely);
 }
 
-BaseType_t TaskRemoveFromEventList(List_t<TCB_t> *const EventList) {
+BaseType_t RemoveFromEventList(List_t<TCB_t> *const EventList) {
   TCB_t *UnblockedTCB = EventList->head()->Owner;
   UnblockedTCB->EventListItem.remove();
   if (SchedulerSuspended == 0U) {
@@ -935,8 +1923,8 @@ BaseType_t TaskRemoveFromEventList(List_t<TCB_t> *const EventList) {
   } else {
     PendingReady.append(&UnblockedTCB->EventListItem);
   }
-  if (UnblockedTCB->Priority > CurrentTCB->Priority) {
-    YieldPendings[0] = true;
+  if (YieldForTask(UnblockedTCB)) {
+    YieldPendings[portGET_CORE_ID()] = true;
     return true;
   }
   return false;
@@ -948,8 +1936,8 @@ void RemoveFromUnorderedEventList(Item_t<TCB_t> *EventListItem, const TickType_t
   EventListItem->remove();
   UnblockedTCB->StateListItem.remove();
   AddTaskToReadyList(UnblockedTCB);
-  if (UnblockedTCB->Priority > CurrentTCB->Priority) {
-    YieldPendings[0] = true;
+  if (YieldForTask(UnblockedTCB)) {
+    YieldPendings[portGET_CORE_ID()] = true;
   }
 }
 void TaskSetTimeOutState(TimeOut_t *const TimeOut) {
@@ -997,24 +1985,122 @@ static void IdleTask(void *) {
   portALLOCATE_SECURE_CONTEXT(configMINIMAL_SECURE_STACK_SIZE);
   for (; configCONTROL_INFINITE_LOOP();) {
     CheckTasksWaitingTermination();
-    if (ReadyTasks[tskIDLE_PRIORITY].Length > (UBaseType_t)configNUMBER_OF_CORES) {
+    if (ReadyTaskCount(tskIDLE_PRIORITY) > (UBaseType_t)configNUMBER_OF_CORES) {
       taskYIELD();
     }
     ApplicationIdleHook();
+#if (configUSE_VIRTUAL_TIME == 1)
+    AdvanceVirtualTime();
+#endif
+#if (configUSE_TICKLESS_IDLE != 0)
+    if (GetExpectedIdleTime() >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP) {
+      TaskSuspendAll();
+      {
+        TickType_t ExpectedIdleTime = GetExpectedIdleTime();
+        configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING(ExpectedIdleTime);
+        if (ExpectedIdleTime >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP) {
+          portSUPPRESS_TICKS_AND_SLEEP(ExpectedIdleTime);
+        }
+      }
+      (void)ResumeAll();
+    }
+#endif
+  }
+}
+
+#if (configNUMBER_OF_CORES > 1)
+// Idle task for every core but the first. Cleaning up deleted tasks and advancing virtual time is left to IdleTask.
+static void PassiveIdleTask(void *) {
+  for (; configCONTROL_INFINITE_LOOP();) {
+    if (ReadyTaskCount(tskIDLE_PRIORITY) > (UBaseType_t)configNUMBER_OF_CORES) {
+      taskYIELD();
+    }
+#if (configUSE_PASSIVE_IDLE_HOOK == 1)
+    ApplicationPassiveIdleHook();
+#endif
+  }
+}
+#endif
+
+#if (configUSE_TICKLESS_IDLE != 0)
+static TickType_t GetExpectedIdleTime(void) {
+  const UBaseType_t topPri = ReadyPriorities().highest();
+  if (topPri > tskIDLE_PRIORITY) {
+    return 0;
+  }
+  if (ReadyTaskCount(tskIDLE_PRIORITY) > (UBaseType_t)configNUMBER_OF_CORES) {
+    return 0;
   }
+  return NextTaskUnblockTime - TickCount;
 }
 
+eSleepModeStatus TaskConfirmSleepModeStatus(void) {
+  if (PendingReady.Length != 0) {
+    return eAbortSleep;
+  }
+  if (YieldPendings[portGET_CORE_ID()]) {
+    return eAbortSleep;
+  }
+  if (PendedTicks != 0) {
+    return eAbortSleep;
+  }
+  if (SuspendedTasks.Length == (CurrentNumberOfTasks - (UBaseType_t)configNUMBER_OF_CORES)) {
+    return eNoTasksWaitingTimeout;
+  }
+  return eStandardSleep;
+}
+#endif
+
+#if (configUSE_VIRTUAL_TIME == 1)
+// Time only passes while the idle task is the only task that can run, and then jumps straight to the next time a
+// delayed task (including the timer daemon waiting for its next timer) unblocks.
+static void AdvanceVirtualTime(void) {
+  TaskSuspendAll();
+  {
+    CriticalSection s;
+    const UBaseType_t topPri = ReadyPriorities().highest();
+    if ((topPri == tskIDLE_PRIORITY) && (ReadyTaskCount(tskIDLE_PRIORITY) <= (UBaseType_t)configNUMBER_OF_CORES) &&
+#if (configUSE_DELAYED_TASK_WHEEL == 1)
+        PendingReady.empty() && !DelayedWheel.empty()) {
+#else
+        PendingReady.empty() && ((NextTaskUnblockTime != portMAX_DELAY) || !OverflowDelayed->empty())) {
+#endif
+      if ((TickType_t)(NextTaskUnblockTime - TickCount) > (TickType_t)1) {
+        TickCount = NextTaskUnblockTime - (TickType_t)1;
+      }
+      PendedTicks += 1U;
+    }
+  }
+  (void)ResumeAll();
+}
+#endif
+
 static void InitialiseTaskLists(void) {
+#if (configNUMBER_OF_CORES == 1)
   for (int pri = 0; pri < configMAX_PRIORITIES; pri++) {
     (ReadyTasks[pri]).init();
   }
-  DelayedTasks1.init();
-  DelayedTasks2.init();
+#else
+  for (int xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+    for (int pri = 0; pri < configMAX_PRIORITIES; pri++) {
+      (ReadyTasks[xCoreID][pri]).init();
+    }
+  }
+#endif
   PendingReady.init();
   TasksWaitingTermination.init();
   SuspendedTasks.init();
+#if (configUSE_TASK_BUDGETS == 1)
+  ThrottledTasks.init();
+#endif
+#if (configUSE_DELAYED_TASK_WHEEL == 1)
+  DelayedWheel.init(TickCount);
+#else
+  DelayedTasks1.init();
+  DelayedTasks2.init();
   DelayedTasks = &DelayedTasks1;
   OverflowDelayed = &DelayedTasks2;
+#endif
 }
 
 static void CheckTasksWaitingTermination(void) {
@@ -1023,6 +2109,12 @@ static void CheckTasksWaitingTermination(void) {
     {
       CriticalSection s;
       TCB = TasksWaitingTermination.head()->Owner;
+#if (configNUMBER_OF_CORES > 1)
+      // A task that deleted itself may not have switched away from its core yet.
+      if (taskTASK_IS_RUNNING(TCB)) {
+        break;
+      }
+#endif
       TCB->StateListItem.remove();
       --CurrentNumberOfTasks;
       --DeletedTasksWaitingCleanUp;
@@ -1031,73 +2123,81 @@ static void CheckTasksWaitingTermination(void) {
   }
 }
 
+#if (configUSE_DELAYED_TASK_WHEEL == 1)
+// Only UnblockExpiredTasks advances the wheel, as it expires every slot it passes, so the wheel may be behind the tick
+// count here. A bound at or before the tick count then has the next tick catch the wheel up. A wake time that has
+// wrapped past the tick count is left for the overflow at tick zero to pick up, as with the overflow list.
+static void ResetNextTaskUnblockTime(void) {
+  TickType_t Next;
+  if (!DelayedWheel.nextExpiry(&Next)) {
+    NextTaskUnblockTime = portMAX_DELAY;
+  } else if ((TickType_t)(Next - DelayedWheel.Now) <= (TickType_t)(TickCount - DelayedWheel.Now)) {
+    NextTaskUnblockTime = TickCount;
+  } else {
+    NextTaskUnblockTime = (Next >= TickCount) ? Next : portMAX_DELAY;
+  }
+}
+#else
 static void ResetNextTaskUnblockTime(void) {
   NextTaskUnblockTime = DelayedTasks->empty() ? portMAX_DELAY : DelayedTasks->head()->Value;
 }
+#endif
 
+#if (configNUMBER_OF_CORES == 1)
 TaskHandle_t CurrentTaskHandle(void) { return CurrentTCB; }
 
+TaskHandle_t GetCurrentTaskHandleForCore(BaseType_t xCoreID) { return (xCoreID == 0) ? CurrentTCB : NULL; }
+#else
+// Interrupts are masked so the calling task cannot be moved to another core between reading the core ID and reading
+// that core's task.
+TaskHandle_t CurrentTaskHandle(void) {
+  const UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+  TaskHandle_t Ret = CurrentTCB;
+  portCLEAR_INTERRUPT_MASK(uxSavedInterruptStatus);
+  return Ret;
+}
+
+TaskHandle_t GetCurrentTaskHandleForCore(BaseType_t xCoreID) {
+  return taskVALID_CORE_ID(xCoreID) ? CurrentTCBs[xCoreID] : NULL;
+}
+#endif
+
 BaseType_t GetSchedulerState(void) {
   return SchedulerRunning ? SchedulerSuspended ? taskSCHEDULER_SUSPENDED : taskSCHEDULER_RUNNING
                           : taskSCHEDULER_NOT_STARTED;
 }
 
-BaseType_t PriorityInherit(TaskHandle_t const pMutexHolder) {
-  TCB_t *const pMutexHolderTCB = pMutexHolder;
-  if (pMutexHolder == NULL) {
+// Called by the current task before it blocks on Mutex. Raises the holder, and whoever holds the mutex the holder
+// waits for, and so on down the chain, to the current task's priority.
+BaseType_t PriorityInherit(MutexLink_t *const Mutex) {
+  TCB_t *const Holder = Mutex->Holder;
+  if (Holder == NULL) {
     return false;
   }
-  if (pMutexHolderTCB->Priority >= CurrentTCB->Priority) {
-    return pMutexHolderTCB->BasePriority < CurrentTCB->Priority;
-  }
-  if ((pMutexHolderTCB->EventListItem.Value & taskEVENT_LIST_ITEM_VALUE_IN_USE) == 0U) {
-    pMutexHolderTCB->EventListItem.Value = (TickType_t)configMAX_PRIORITIES - (TickType_t)CurrentTCB->Priority;
-  }
-  if (pMutexHolderTCB->StateListItem.Container == &(ReadyTasks[pMutexHolderTCB->Priority])) {
-    if (pMutexHolderTCB->StateListItem.remove() == 0) {
-      portRESET_READY_PRIORITY(pMutexHolderTCB->Priority, TopReadyPriority);
-    }
-    pMutexHolderTCB->Priority = CurrentTCB->Priority;
-    AddTaskToReadyList(pMutexHolderTCB);
-  } else {
-    pMutexHolderTCB->Priority = CurrentTCB->Priority;
+  CurrentTCB->BlockedOn = Mutex;
+  const BaseType_t Inherited = Holder->RestPriority() < CurrentTCB->Priority;
+  for (TCB_t *TCB = Holder; (TCB != NULL) && (TCB->Priority < CurrentTCB->Priority); TCB = TCB->BlockingHolder()) {
+    MoveToPriority(TCB, CurrentTCB->Priority);
   }
-  return true;
+  return Inherited;
 }
 
-BaseType_t PriorityDisinherit(TCB_t *const TCB) {
-  BaseType_t Ret = false;
+BaseType_t PriorityDisinherit(MutexLink_t *const Mutex) {
+  TCB_t *const TCB = Mutex->Holder;
   if (TCB == NULL) {
     return false;
   }
-  return TCB->PriorityDisinherit();
+  Mutex->HeldItem.remove();
+  Mutex->Holder = NULL;
+  return UpdateInheritance(TCB);
 }
 
-void PriorityDisinheritAfterTimeout(TaskHandle_t const pMutexHolder, UBaseType_t uxHighestPriorityWaitingTask) {
-  TCB_t *const TCB = pMutexHolder;
-  UBaseType_t PriorityUsedOnEntry, PriorityToUse;
-  const UBaseType_t uxOnlyOneMutexHeld = (UBaseType_t)1;
-  if (pMutexHolder != NULL) {
-    if (TCB->BasePriority < uxHighestPriorityWaitingTask) {
-      PriorityToUse = uxHighestPriorityWaitingTask;
-    } else {
-      PriorityToUse = TCB->BasePriority;
-    }
-    if (TCB->Priority != PriorityToUse) {
-      if (TCB->MutexesHeld == uxOnlyOneMutexHeld) {
-        PriorityUsedOnEntry = TCB->Priority;
-        TCB->Priority = PriorityToUse;
-        if ((TCB->EventListItem.Value & taskEVENT_LIST_ITEM_VALUE_IN_USE) == 0U) {
-          TCB->EventListItem.Value = (TickType_t)configMAX_PRIORITIES - (TickType_t)PriorityToUse;
-        }
-        if (TCB->StateListItem.Container == &ReadyTasks[PriorityUsedOnEntry]) {
-          if (TCB->StateListItem.remove() == 0) {
-            portRESET_READY_PRIORITY(TCB->Priority, TopReadyPriority);
-          }
-          AddTaskToReadyList(TCB);
-        }
-      }
-    }
+// Called by the current task when it gives up waiting for Mutex, which leaves the holder and the chain below it owed
+// less.
+void PriorityDisinheritAfterTimeout(MutexLink_t *const Mutex) {
+  CurrentTCB->BlockedOn = NULL;
+  if (Mutex->Holder != NULL) {
+    (void)UpdateInheritance(Mutex->Holder);
   }
 }
 
@@ -1130,14 +2230,86 @@ TickType_t ResetEventItemValue(void) {
   return uRet;
 }
 
-TaskHandle_t IncMutexHeldCount(void) {
-  TCB_t *TCB = CurrentTCB;
+void MutexTaken(MutexLink_t *const Mutex) {
+  TCB_t *const TCB = CurrentTCB;
+  Mutex->Holder = TCB;
   if (TCB != NULL) {
-    (TCB->MutexesHeld)++;
+    TCB->BlockedOn = NULL;
+    TCB->HeldMutexes.append(&Mutex->HeldItem);
+    if (Mutex->Ceiling != tskIDLE_PRIORITY) {
+      // The ceiling covers every task that can wait, so there is nothing to inherit from them.
+      if (Mutex->Ceiling > TCB->Priority) {
+        MoveToPriority(TCB, Mutex->Ceiling);
+      }
+    } else {
+      // Tasks still waiting may outrank a holder that took the mutex ahead of them.
+      (void)UpdateInheritance(TCB);
+    }
+  }
+}
+
+// Moves the first task waiting on EventList over to the waiters of the held Mutex without waking it, and raises the
+// holder as if the task had blocked on the mutex itself. The task was signalled, so the timeout of its wait on
+// EventList no longer applies and it waits for the mutex without one.
+void RequeueOnMutex(List_t<TCB_t> *const EventList, MutexLink_t *const Mutex) {
+  TCB_t *const TCB = EventList->head()->Owner;
+  TCB->Signalled = true;
+  TCB->EventListItem.remove();
+  Mutex->Waiters->insert(&TCB->EventListItem);
+  TCB->BlockedOn = Mutex;
+  if (TCB->StateListItem.Container != &SuspendedTasks) {
+    TCB->StateListItem.remove();
+    SuspendedTasks.append(&TCB->StateListItem);
   }
-  return TCB;
+  (void)UpdateInheritance(Mutex->Holder);
+}
+
+// Wakes the first task waiting on EventList as signalled.
+BaseType_t SignalFromEventList(List_t<TCB_t> *const EventList) {
+  EventList->head()->Owner->Signalled = true;
+  return RemoveFromEventList(EventList);
+}
+
+// Whether the current task was signalled since the last call.
+BaseType_t TaskTakeSignal(void) {
+  const BaseType_t Signalled = CurrentTCB->Signalled;
+  CurrentTCB->Signalled = false;
+  return Signalled;
 }
 
+#if (configUSE_MUTEX_FAST_PATH == 1)
+// Links a mutex that its holder took on the fast path into the holder's held mutexes, once another task has to wait
+// for it.
+void MutexAdopt(MutexLink_t *const Mutex) { Mutex->Holder->HeldMutexes.append(&Mutex->HeldItem); }
+#endif
+
+#if (configUSE_ADAPTIVE_MUTEX == 1)
+// True while Task runs on a core other than the caller's, so that it may give back a mutex without the caller blocking.
+BaseType_t TaskRunningElsewhere(const TaskHandle_t Task) {
+  const BaseType_t CoreID = Task->TaskRunState;
+  return (CoreID >= 0) && (CoreID != (BaseType_t)portGET_CORE_ID());
+}
+#endif
+
+#if (configUSE_QUEUE_HANDOFF == 1)
+// Sets the buffer the current task receives into while it waits on a queue, and returns the one it had. That is NULL
+// if a sender took it.
+void *TaskSetHandoffBuffer(void *const Buffer) {
+  void *const Previous = CurrentTCB->HandoffBuffer;
+  CurrentTCB->HandoffBuffer = Buffer;
+  return Previous;
+}
+
+// Takes the buffer of the first task waiting on EventList, or returns NULL if it left none. Called in a critical
+// section by a sender that fills the buffer and wakes the task before leaving it.
+void *TaskTakeHandoffBuffer(List_t<TCB_t> *const EventList) {
+  TCB_t *const TCB = EventList->head()->Owner;
+  void *const Buffer = TCB->HandoffBuffer;
+  TCB->HandoffBuffer = NULL;
+  return Buffer;
+}
+#endif
+
 uint32_t ulTaskGenericNotifyTake(UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t TicksToWait) {
   uint32_t ulReturn;
   BaseType_t xAlreadyYielded, ShouldBlock = false;
@@ -1299,11 +2471,11 @@ BaseType_t GenericNotifyFromISR(TaskHandle_t TaskToNotify, UBaseType_t uxIndexTo
       } else {
         PendingReady.append(&TCB->EventListItem);
       }
-      if (TCB->Priority > CurrentTCB->Priority) {
+      if (YieldForTask(TCB)) {
         if (HigherPriorityTaskWoken != NULL) {
           *HigherPriorityTaskWoken = true;
         }
-        YieldPendings[0] = true;
+        YieldPendings[portGET_CORE_ID()] = true;
       }
     }
   }
@@ -1330,11 +2502,11 @@ void GenericNotifyGiveFromISR(TaskHandle_t TaskToNotify, UBaseType_t uxIndexToNo
       } else {
         PendingReady.append(&TCB->EventListItem);
       }
-      if (TCB->Priority > CurrentTCB->Priority) {
+      if (YieldForTask(TCB)) {
         if (HigherPriorityTaskWoken != NULL) {
           *HigherPriorityTaskWoken = true;
         }
-        YieldPendings[0] = true;
+        YieldPendings[portGET_CORE_ID()] = true;
       }
     }
   }
@@ -1364,17 +2536,31 @@ uint32_t ulTaskGenericNotifyValueClear(TaskHandle_t Task, UBaseType_t IndexToCle
 static void AddCurrentTaskToDelayedList(TickType_t TicksToWait, const BaseType_t CanBlockIndefinitely) {
   TickType_t TimeToWake;
   const TickType_t ConstTickCount = TickCount;
+#if (configUSE_DELAYED_TASK_WHEEL == 0)
   auto *DelayedList = DelayedTasks;
   auto *OverflowDelayedList = OverflowDelayed;
+#endif
   CurrentTCB->DelayAborted = (uint8_t) false;
   if (CurrentTCB->StateListItem.remove() == (UBaseType_t)0) {
-    portRESET_READY_PRIORITY(CurrentTCB->Priority, TopReadyPriority);
+    taskTOP_READY_PRIORITY(CurrentTCB).reset(CurrentTCB->Priority);
   }
   if ((TicksToWait == portMAX_DELAY) && (CanBlockIndefinitely)) {
     SuspendedTasks.append(&CurrentTCB->StateListItem);
   } else {
     TimeToWake = ConstTickCount + TicksToWait;
     CurrentTCB->StateListItem.Value = TimeToWake;
+#if (configUSE_DELAYED_TASK_WHEEL == 1)
+    // The wheel places a wake time relative to its own Now, which only moves when slots are expired, so it is caught
+    // up to the tick count first. Tasks it unblocks are scheduled when the current task yields to block.
+    if (DelayedWheel.Now != ConstTickCount) {
+      (void)UnblockExpiredTasks(ConstTickCount);
+    }
+    DelayedWheel.insert(&(CurrentTCB->StateListItem));
+    TimeToWake = CurrentTCB->StateListItem.Value;
+    if ((TimeToWake > ConstTickCount) && (TimeToWake < NextTaskUnblockTime)) {
+      NextTaskUnblockTime = TimeToWake;
+    }
+#else
     if (TimeToWake < ConstTickCount) {
       OverflowDelayedList->insert(&(CurrentTCB->StateListItem));
     } else {
@@ -1383,6 +2569,7 @@ static void AddCurrentTaskToDelayedList(TickType_t TicksToWait, const BaseType_t
         NextTaskUnblockTime = TimeToWake;
       }
     }
+#endif
   }
 }
 
@@ -1394,6 +2581,17 @@ void GetIdleTaskMemory(StaticTask_t **TCBBuffer, StackType_t **StackBuffer, conf
   *StackSize = configMINIMAL_STACK_SIZE;
 }
 
+#if (configNUMBER_OF_CORES > 1)
+void GetPassiveIdleTaskMemory(StaticTask_t **TCBBuffer, StackType_t **StackBuffer, configSTACK_DEPTH_TYPE *StackSize,
+                              BaseType_t PassiveIdleTaskIndex) {
+  static StaticTask_t TCBs[configNUMBER_OF_CORES - 1];
+  static StackType_t Stacks[configNUMBER_OF_CORES - 1][configMINIMAL_STACK_SIZE];
+  *TCBBuffer = &TCBs[PassiveIdleTaskIndex];
+  *StackBuffer = &Stacks[PassiveIdleTaskIndex][0];
+  *StackSize = configMINIMAL_STACK_SIZE;
+}
+#endif
+
 void ApplicationGetTimerTaskMemory(StaticTask_t **TCBBuffer, StackType_t **StackBuffer,
                                    configSTACK_DEPTH_TYPE *StackSize) {
   static StaticTask_t TCB;
@@ -1405,18 +2603,36 @@ void ApplicationGetTimerTaskMemory(StaticTask_t **TCBBuffer, StackType_t **Stack
 
 void TaskResetState(void) {
   BaseType_t xCoreID;
+#if (configNUMBER_OF_CORES == 1)
   CurrentTCB = NULL;
+#else
+  for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+    CurrentTCBs[xCoreID] = NULL;
+  }
+#endif
   DeletedTasksWaitingCleanUp = 0U;
   CurrentNumberOfTasks = 0U;
   TickCount = (TickType_t)configINITIAL_TICK_COUNT;
-  TopReadyPriority = tskIDLE_PRIORITY;
+#if (configNUMBER_OF_CORES == 1)
+  TopReadyPriority.init();
+#endif
   SchedulerRunning = false;
   PendedTicks = 0U;
   for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
     YieldPendings[xCoreID] = false;
+#if (configNUMBER_OF_CORES > 1)
+    TopReadyPriorities[xCoreID].init();
+#endif
   }
   NOverflows = 0;
   TaskNumber = 0U;
   NextTaskUnblockTime = 0U;
   SchedulerSuspended = 0U;
+#if (configUSE_EDF_SCHEDULING == 1)
+  EDFReady.init();
+  EDFTasks = 0U;
+#endif
+#if (configUSE_TASK_BUDGETS == 1)
+  NextReplenishTime = 0U;
+#endif
 }
@@ -0,0 +1,30 @@
+// Delays across a tick count overflow after the delayed task wheel has been idle for most of a tick period. The wake
+// time must be placed relative to the current tick rather than to wherever the wheel last expired a slot.
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.hpp"
+
+void ApplicationIdleHook(void) {}
+void ApplicationTickHook(void) {}
+
+static void Check(void *) {
+  const TickType_t Period = 0x400U;
+  // Leaves the wheel at tick 0x64. Nothing is delayed while the tick count is then caught up to just short of the
+  // overflow, so the wake time 0x38d only differs from the wheel's position below its top level.
+  (void)CatchUpTicks((TickType_t)0x63U - TaskGetTickCount());
+  Delay(1U);
+  (void)CatchUpTicks((TickType_t)0xFFFFFF8DU - TaskGetTickCount());
+  const TickType_t Start = TaskGetTickCount();
+  Delay(Period);
+  const TickType_t Slept = TaskGetTickCount() - Start;
+  printf("delayed %u ticks from %#x, slept %u\n", (unsigned)Period, (unsigned)Start, (unsigned)Slept);
+  exit(((Slept >= Period) && (Slept <= Period + 1U)) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+int main() {
+  TaskCreate(Check, "check", configMINIMAL_STACK_SIZE * 4U, NULL, tskIDLE_PRIORITY + 1U, NULL);
+  TaskStartScheduler();
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,42 @@
+// Starts a one-shot timer across a tick count overflow after the timer daemon has slept on an empty wheel for most of
+// a tick period. The expiry must be placed relative to the current tick rather than to where the daemon last blocked.
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.hpp"
+#include "timers.h"
+
+void ApplicationIdleHook(void) {}
+void ApplicationTickHook(void) {}
+
+static volatile TickType_t Fired = 0U;
+static volatile bool HasFired = false;
+
+static void Expired(TimerHandle_t) {
+  Fired = TaskGetTickCount();
+  HasFired = true;
+}
+
+static void Check(void *) {
+  const TickType_t Period = 0x400U;
+  TimerHandle_t Timer = TimerCreate("wrap", Period, false, NULL, Expired);
+  // The daemon outranks this task, so it handles the stop and blocks with its wheel at tick 0x64. The expiry 0x329
+  // then only differs from the wheel's position below its top level.
+  (void)CatchUpTicks((TickType_t)0x64U - TaskGetTickCount());
+  (void)TimerStop(Timer, portMAX_DELAY);
+  (void)CatchUpTicks((TickType_t)0xFFFFFF29U - TaskGetTickCount());
+  const TickType_t Start = TaskGetTickCount();
+  (void)TimerStart(Timer, portMAX_DELAY);
+  Delay(Period * 2U);
+  const TickType_t Waited = Fired - Start;
+  printf("period %u from %#x, fired %s after %u\n", (unsigned)Period, (unsigned)Start, HasFired ? "yes" : "no",
+         (unsigned)Waited);
+  exit((HasFired && (Waited >= Period) && (Waited <= Period + 1U)) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+int main() {
+  TaskCreate(Check, "check", configMINIMAL_STACK_SIZE * 4U, NULL, tskIDLE_PRIORITY + 1U, NULL);
+  TaskStartScheduler();
+  return EXIT_FAILURE;
+}
@@ -35,6 +35,9 @@
 #include "FreeRTOS.h"
 #include "queue.h"
 #include "task.hpp"
+#if (configUSE_TIMER_WHEEL == 1)
+#include "timing_wheel.hpp"
+#endif
 
 #define tmrNO_DELAY ((TickType_t)0U)
 #define tmrMAX_TIME_BEFORE_OVERFLOW ((TickType_t)-1)
@@ -92,10 +95,16 @@ typedef struct tmrTimerQueueMessage {
   } u;
 } DaemonTaskMessage_t;
 
+#if (configUSE_TIMER_WHEEL == 1)
+// Active timers keyed on their expiry time. The wheel's own Now is the last expiry time the daemon has processed, so it
+// can lag the tick count while expired timers wait to be processed, and every comparison is made relative to it.
+static TimingWheel_t<Timer_t> TimerWheel;
+#else
 static List_t<Timer_t> ActiveTimerList1;
 static List_t<Timer_t> ActiveTimerList2;
 static List_t<Timer_t> *CurrentTimerList;
 static List_t<Timer_t> *OverflowTimerList;
+#endif
 
 static QueueHandle_t TimerQueue = NULL;
 static TaskHandle_t TimerTaskHandle = NULL;
@@ -244,8 +253,7 @@ static void ReloadTimer(Timer_t *const t, TickType_t Expired, const TickType_t N
   }
 }
 
-static void ProcessExpiredTimer(const TickType_t NextExpire, const TickType_t Now) {
-  Timer_t *const t = CurrentTimerList->head()->Owner;
+static void ExpireTimer(Timer_t *const t, const TickType_t NextExpire, const TickType_t Now) {
   t->TimerListItem.remove();
   if (t->Autoreload()) {
     ReloadTimer(t, NextExpire, Now);
@@ -255,6 +263,19 @@ static void ProcessExpiredTimer(const TickType_t NextExpire, const TickType_t No
   t->Callback((Timer_t *)t);
 }
 
+static void ProcessExpiredTimer(const TickType_t NextExpire, const TickType_t Now) {
+#if (configUSE_TIMER_WHEEL == 1)
+  // NextExpire may only be the start of a wheel slot, in which case moving to it just cascades the slot. Otherwise every
+  // timer left in the slot expires at NextExpire.
+  List_t<Timer_t> *const Expired = TimerWheel.advance(NextExpire);
+  while (!Expired->empty()) {
+    ExpireTimer(Expired->head()->Owner, NextExpire, Now);
+  }
+#else
+  ExpireTimer(CurrentTimerList->head()->Owner, NextExpire, Now);
+#endif
+}
+
 static portTASK_FUNCTION(TimerTask, Params) {
   TickType_t NextExpire;
   BaseType_t ListWasEmpty;
@@ -275,11 +296,21 @@ static void ProcessTimerOrBlockTask(const TickType_t NextExpire, BaseType_t List
     ResumeAll();
     return;
   }
+#if (configUSE_TIMER_WHEEL == 1)
+  if ((ListWasEmpty == false) && ((TickType_t)(NextExpire - TimerWheel.Now) <= (TickType_t)(Now - TimerWheel.Now))) {
+#else
   if ((ListWasEmpty == false) && (NextExpire <= Now)) {
+#endif
     ResumeAll();
     ProcessExpiredTimer(NextExpire, Now);
   } else {
-    ListWasEmpty |= OverflowTimerList->empty();
+#if (configUSE_TIMER_WHEEL == 1)
+    (void)TimerWheel.advance(Now);
+#else
+    if (ListWasEmpty) {
+      ListWasEmpty = OverflowTimerList->empty();
+    }
+#endif
     vQueueWaitForMessageRestricted(TimerQueue, (NextExpire - Now), ListWasEmpty);
     if (!ResumeAll()) {
       taskYIELD_WITHIN_API();
@@ -289,13 +320,18 @@ static void ProcessTimerOrBlockTask(const TickType_t NextExpire, BaseType_t List
 
 static TickType_t GetNextExpireTime(BaseType_t *const ListWasEmpty) {
   TickType_t NextExpire;
+#if (configUSE_TIMER_WHEEL == 1)
+  *ListWasEmpty = !TimerWheel.nextExpiry(&NextExpire);
+  return *ListWasEmpty ? 0 : NextExpire;
+#else
   *ListWasEmpty = CurrentTimerList->empty();
   return *ListWasEmpty ? 0 : CurrentTimerList->head()->Value;
+#endif
 }
 
 static TickType_t SampleTimeNow(BaseType_t *const switched) {
   static TickType_t xLastTime = (TickType_t)0U;
-  TickType_t Now = GetTickCount();
+  TickType_t Now = TaskGetTickCount();
   *switched = Now < xLastTime;
   if (*switched) {
     SwitchTimerLists();
@@ -309,6 +345,13 @@ static BaseType_t InsertTimerInActiveList(Timer_t *const pTimer, const TickType_
   BaseType_t xProcessTimerNow = false;
   pTimer->TimerListItem.Value = xNextExpiryTime;
   pTimer->TimerListItem.Owner = pTimer;
+#if (configUSE_TIMER_WHEEL == 1)
+  if (((TickType_t)(Now - xCommandTime)) >= pTimer->Period) {
+    xProcessTimerNow = true;
+  } else {
+    TimerWheel.insert(&(pTimer->TimerListItem));
+  }
+#else
   if (xNextExpiryTime <= Now) {
     if (((TickType_t)(Now - xCommandTime)) >= pTimer->Period) {
       xProcessTimerNow = true;
@@ -322,9 +365,24 @@ static BaseType_t InsertTimerInActiveList(Timer_t *const pTimer, const TickType_
       CurrentTimerList->insert(&(pTimer->TimerListItem));
     }
   }
+#endif
   return xProcessTimerNow;
 }
 
+#if (configUSE_TIMER_WHEEL == 1)
+// The wheel places an expiry relative to its own Now, which only moves when the daemon expires a slot or is about to
+// block, so it is caught up to the sampled time before a timer is inserted. Timers that fall due on the way expire
+// first.
+static void CatchUpTimerWheel(const TickType_t Now) {
+  TickType_t NextExpire;
+  while (TimerWheel.nextExpiry(&NextExpire) &&
+         ((TickType_t)(NextExpire - TimerWheel.Now) <= (TickType_t)(Now - TimerWheel.Now))) {
+    ProcessExpiredTimer(NextExpire, Now);
+  }
+  (void)TimerWheel.advance(Now);
+}
+#endif
+
 static void ProcessReceivedCommands(void) {
   DaemonTaskMessage_t msg = {0};
   Timer_t *pTimer;
@@ -341,6 +399,9 @@ static void ProcessReceivedCommands(void) {
         pTimer->TimerListItem.remove();
       }
       now = SampleTimeNow(&switched);
+#if (configUSE_TIMER_WHEEL == 1)
+      CatchUpTimerWheel(now);
+#endif
       switch (msg.ID) {
         case tmrCOMMAND_START:
         case tmrCOMMAND_START_FROM_ISR:
@@ -381,6 +442,10 @@ static void ProcessReceivedCommands(void) {
   }
 }
 
+#if (configUSE_TIMER_WHEEL == 1)
+// The wheel covers the whole tick range, so timers due before the overflow are simply processed in order afterwards.
+static void SwitchTimerLists(void) {}
+#else
 static void SwitchTimerLists(void) {
   TickType_t NextExpire;
   List_t<Timer_t> *Temp;
@@ -392,16 +457,21 @@ static void SwitchTimerLists(void) {
   CurrentTimerList = OverflowTimerList;
   OverflowTimerList = Temp;
 }
+#endif
 
 static void CheckForValidListAndQueue(void) {
   CriticalSection s;
   if (TimerQueue != NULL) {
     return;
   }
+#if (configUSE_TIMER_WHEEL == 1)
+  TimerWheel.init(TaskGetTickCount());
+#else
   ActiveTimerList1.init();
   ActiveTimerList2.init();
   CurrentTimerList = &ActiveTimerList1;
   OverflowTimerList = &ActiveTimerList2;
+#endif
   static StaticQueue_t StaticTimerQueue;
   static uint8_t StaticTimerQueueStorage[(size_t)configTIMER_QUEUE_LENGTH * sizeof(DaemonTaskMessage_t)];
   TimerQueue = QueueCreateStatic((UBaseType_t)configTIMER_QUEUE_LENGTH, (UBaseType_t)sizeof(DaemonTaskMessage_t),